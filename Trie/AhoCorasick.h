@@ -0,0 +1,222 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "TrieNode.h"
+
+// Aho-Corasick automaton over the entries of a Trie, matching all of them in
+// one pass over a text. States are the trie's nodes numbered breadth first
+// with the root as 0, so the children of a state are consecutive states. A
+// state's failure link is the state of its longest proper suffix in the trie
+// and m_firstMatch chains every entry ending at a state through those links.
+// The automaton is immutable and holds a handle to every node it reports.
+template< typename NodeTy, typename CharTy >
+class AhoCorasick
+{
+public:
+  typedef typename NodeTy::Allocator Allocator;
+  typedef typename Allocator::template Pointer< NodeTy > NodePtr;
+  static constexpr uint32_t NoState = std::numeric_limits< uint32_t >::max();
+
+  // Matching position in one text stream. Any number of scanners may share
+  // an automaton, each keeps its own state across the chunks it is given.
+  class Scanner
+  {
+  public:
+    explicit Scanner( AhoCorasick const& automaton )
+      : m_automaton { &automaton }, m_state { 0U }, m_offset { 0ULL }
+    {
+
+    }
+
+    // Feeds the next chunk of the stream, calling fn( offset, node ) for
+    // every entry ending in it, where offset is where the match starts in the
+    // whole stream. Matches may start in earlier chunks.
+    template< typename FnTy >
+    void Scan( std::basic_string< CharTy > const& chunk, FnTy&& fn )
+    {
+      Scan( chunk.begin(), chunk.end(), std::forward< FnTy >( fn ) );
+    }
+
+    template< typename IterTy, typename FnTy >
+    void Scan( IterTy begin, IterTy const& end, FnTy&& fn )
+    {
+      auto const& automaton { *m_automaton };
+      for( ; begin != end; ++begin )
+      {
+        m_state = automaton.Next( m_state, *begin );
+        ++m_offset;
+        for( auto match { automaton.m_firstMatch[m_state] }; match != NoState; match = automaton.m_nextMatch[match] )
+        {
+          fn( m_offset - automaton.m_depths[match], automaton.m_nodes[match] );
+        }
+      }
+    }
+
+    // Starts a new stream
+    void Reset()
+    {
+      m_state = 0U;
+      m_offset = 0ULL;
+    }
+
+    // Number of characters scanned since the stream started
+    size_t const GetOffset() const
+    {
+      return m_offset;
+    }
+
+  private:
+    AhoCorasick const* m_automaton;
+    uint32_t m_state;
+    size_t m_offset;
+  };
+
+  #pragma region Constructors
+  template< typename NodePtrTy >
+  explicit AhoCorasick( NodePtrTy const& root )
+  {
+    static_assert( std::is_base_of< TrieNode< CharTy, Allocator, typename NodeTy::Alphabet, typename NodeTy::Instrumentation >, NodeTy >::value, "Must use a TrieNode type" );
+    if( root != nullptr )
+    {
+      Build( root );
+    }
+  }
+  #pragma endregion
+
+  // The automaton must outlive the scanner
+  Scanner NewScanner() const
+  {
+    return Scanner( *this );
+  }
+
+  // Scans text as a stream of its own
+  template< typename FnTy >
+  void Scan( std::basic_string< CharTy > const& text, FnTy&& fn ) const
+  {
+    NewScanner().Scan( text, std::forward< FnTy >( fn ) );
+  }
+
+  size_t const GetNumStates() const
+  {
+    return m_nodes.size();
+  }
+
+private:
+  static constexpr bool HasRootTable = sizeof( CharTy ) == 1ULL;
+
+  std::vector< NodePtr > m_nodes;
+  std::vector< CharTy > m_chars;
+  std::vector< uint32_t > m_firstChild;
+  std::vector< uint32_t > m_failures;
+  std::vector< uint32_t > m_depths;
+  std::vector< uint32_t > m_firstMatch;
+  std::vector< uint32_t > m_nextMatch;
+  std::vector< uint32_t > m_rootNext;
+
+  static size_t const CharIndex( CharTy const c )
+  {
+    return NodeTy::CharIndex( c );
+  }
+
+  // The child of state on c, or NoState
+  uint32_t const GetChild( uint32_t const state, CharTy const c ) const
+  {
+    auto const first { m_chars.begin() + m_firstChild[state] };
+    auto const last { m_chars.begin() + m_firstChild[state + 1U] };
+    auto const it { std::lower_bound( first, last, c, []( CharTy const lhs, CharTy const rhs )
+    {
+      return CharIndex( lhs ) < CharIndex( rhs );
+    } ) };
+    return ( it == last || *it != c ) ? NoState : static_cast< uint32_t >( it - m_chars.begin() );
+  }
+
+  // The state after reading c in state, following failure links until some
+  // suffix can be extended, or the root
+  uint32_t const Next( uint32_t state, CharTy const c ) const
+  {
+    while( state != 0U )
+    {
+      auto const child { GetChild( state, c ) };
+      if( child != NoState )
+      {
+        return child;
+      }
+      state = m_failures[state];
+    }
+
+    if( HasRootTable )
+    {
+      return m_rootNext[CharIndex( c )];
+    }
+    auto const child { GetChild( 0U, c ) };
+    return ( child == NoState ) ? 0U : child;
+  }
+
+  template< typename NodePtrTy >
+  void Build( NodePtrTy const& root )
+  {
+    // breadth first numbering, a state's children are appended when it is reached
+    m_nodes.push_back( root );
+    m_chars.push_back( static_cast< CharTy >( 0 ) );
+    m_depths.push_back( 0U );
+    for( size_t state { 0ULL }; state < m_nodes.size(); ++state )
+    {
+      m_firstChild.push_back( static_cast< uint32_t >( m_nodes.size() ) );
+      auto const depth { m_depths[state] + 1U };
+      m_nodes[state]->ForEachChild( [this, depth]( typename NodeTy::NodePtr const& child )
+      {
+        m_nodes.push_back( Allocator::template Cast< NodeTy >( child ) );
+        m_chars.push_back( child->GetChar() );
+        m_depths.push_back( depth );
+      } );
+    }
+    m_firstChild.push_back( static_cast< uint32_t >( m_nodes.size() ) );
+
+    if( HasRootTable )
+    {
+      // characters outside the alphabet index one past its end
+      m_rootNext.assign( NodeTy::NumChars + 1ULL, 0U );
+      for( auto child { m_firstChild[0] }; child < m_firstChild[1]; ++child )
+      {
+        m_rootNext[CharIndex( m_chars[child] )] = child;
+      }
+    }
+
+    // parents come before their children, so every state's failure link is
+    // set before its children need it
+    uint32_t const noState { NoState };
+    m_failures.assign( m_nodes.size(), 0U );
+    m_firstMatch.assign( m_nodes.size(), noState );
+    m_nextMatch.assign( m_nodes.size(), noState );
+    for( uint32_t state { 0U }; state < m_nodes.size(); ++state )
+    {
+      for( auto child { m_firstChild[state] }; child < m_firstChild[state + 1U]; ++child )
+      {
+        auto const failure { ( state == 0U ) ? 0U : Next( m_failures[state], m_chars[child] ) };
+        m_failures[child] = failure;
+        m_nextMatch[child] = m_firstMatch[failure];
+        m_firstMatch[child] = m_nodes[child]->IsEndOfAnEntry() ? child : m_firstMatch[failure];
+      }
+    }
+  }
+};
@@ -0,0 +1,137 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Alphabets map characters to child indexes. Index( c ) is in [0, Size) for
+// a character of the alphabet, in the same order as the characters, and
+// Size for any other character, which tries reject. Full alphabets hold
+// every value of CharTy. Characters are ordered as unsigned values, as they
+// are everywhere else keys are ordered, so a signed char such as '\xE9'
+// comes after 'z'.
+template< typename CharTy >
+struct FullAlphabet
+{
+  static constexpr size_t Size = 1ULL << 8ULL * sizeof( CharTy );
+  static constexpr bool IsFull = true;
+
+  static constexpr size_t Index( CharTy const c )
+  {
+    return static_cast< size_t >( static_cast< typename std::make_unsigned< CharTy >::type >( c ) );
+  }
+};
+
+// The characters First through Last
+template< typename CharTy, CharTy First, CharTy Last >
+struct RangeAlphabet
+{
+  static_assert( FullAlphabet< CharTy >::Index( First ) <= FullAlphabet< CharTy >::Index( Last ), "Alphabet range must not be empty" );
+  static constexpr size_t Size = FullAlphabet< CharTy >::Index( Last ) - FullAlphabet< CharTy >::Index( First ) + 1ULL;
+  static constexpr bool IsFull = Size == FullAlphabet< CharTy >::Size;
+
+  static constexpr size_t Index( CharTy const c )
+  {
+    // characters before First wrap around past Size
+    auto const offset { FullAlphabet< CharTy >::Index( c ) - FullAlphabet< CharTy >::Index( First ) };
+    return ( offset < Size ) ? offset : Size;
+  }
+};
+
+// The listed characters, which must be in ascending unsigned order. Byte characters
+// are looked up in a table, wider ones by binary search.
+template< typename CharTy, CharTy... Chars >
+struct ListAlphabet
+{
+  static constexpr size_t Size = sizeof...( Chars );
+  static constexpr bool IsFull = Size == FullAlphabet< CharTy >::Size;
+
+  static constexpr size_t Index( CharTy const c )
+  {
+    return IndexOf( c, std::integral_constant< bool, sizeof( CharTy ) == 1ULL >() );
+  }
+
+private:
+  static_assert( Size > 0ULL && Size <= 255ULL, "Alphabet must have 1 to 255 characters" );
+
+  struct Table
+  {
+    uint8_t indexes[256];
+
+    constexpr Table()
+      : indexes {}
+    {
+      CharTy const chars[] { Chars... };
+      for( size_t i { 0ULL }; i < 256ULL; ++i )
+      {
+        indexes[i] = static_cast< uint8_t >( Size );
+      }
+      for( size_t i { 0ULL }; i < Size; ++i )
+      {
+        indexes[FullAlphabet< CharTy >::Index( chars[i] )] = static_cast< uint8_t >( i );
+      }
+    }
+  };
+
+  static constexpr bool IsAscending()
+  {
+    CharTy const chars[] { Chars... };
+    for( size_t i { 1ULL }; i < Size; ++i )
+    {
+      if( !( FullAlphabet< CharTy >::Index( chars[i - 1ULL] ) < FullAlphabet< CharTy >::Index( chars[i] ) ) )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+  static_assert( IsAscending(), "Alphabet characters must be listed in ascending order" );
+
+  static constexpr Table s_table {};
+
+  static constexpr size_t IndexOf( CharTy const c, std::true_type )
+  {
+    return s_table.indexes[FullAlphabet< CharTy >::Index( c )];
+  }
+
+  static constexpr size_t IndexOf( CharTy const c, std::false_type )
+  {
+    CharTy const chars[] { Chars... };
+    size_t first { 0ULL };
+    size_t last { Size };
+    while( first < last )
+    {
+      auto const mid { first + ( last - first ) / 2ULL };
+      if( FullAlphabet< CharTy >::Index( chars[mid] ) < FullAlphabet< CharTy >::Index( c ) )
+      {
+        first = mid + 1ULL;
+      }
+      else
+      {
+        last = mid;
+      }
+    }
+    return ( first < Size && chars[first] == c ) ? first : Size;
+  }
+};
+
+template< typename CharTy, CharTy... Chars >
+constexpr typename ListAlphabet< CharTy, Chars... >::Table ListAlphabet< CharTy, Chars... >::s_table;
+
+typedef ListAlphabet< char, 'A', 'C', 'G', 'T' > DnaAlphabet;
+typedef RangeAlphabet< char, 'a', 'z' > LowercaseAlphabet;
+typedef ListAlphabet< char, '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' > HexAlphabet;
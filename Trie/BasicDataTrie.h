@@ -0,0 +1,96 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include "BasicTrie.h"
+
+template< typename NodeTy, typename CharTy, typename DataTy >
+class BasicDataTrie : public BasicTrie< NodeTy, CharTy >
+{
+public:
+  typedef typename BasicTrie< NodeTy, CharTy >::NodePtr NodePtr;
+
+  NodePtr const Insert( std::basic_string< CharTy > const& str )
+  {
+    return Insert( str.begin(), str.end(), DataTy() );
+  }
+
+  NodePtr const Insert( CharTy const* const str )
+  {
+    return Insert( &str[0], &str[std::char_traits< CharTy >::length( str )], DataTy() );
+  }
+
+  // data is moved the rest of the way into the node
+  NodePtr const Insert( std::basic_string< CharTy > const& str, DataTy data )
+  {
+    return Insert( str.begin(), str.end(), std::move( data ) );
+  }
+
+  NodePtr const Insert( CharTy const* const str, DataTy data )
+  {
+    return Insert( &str[0], &str[std::char_traits< CharTy >::length( str )], std::move( data ) );
+  }
+
+  template< typename IterTy >
+  NodePtr const Insert( IterTy&& begin, IterTy&& end, DataTy data )
+  {
+    return NodeTy::Insert( this->m_root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ), std::move( data ), this->m_arena );
+  }
+
+  // Inserts str with data built from args, replacing any data it had. The
+  // data of a new node is built in place, existing data is assigned.
+  template< typename... ArgsTy >
+  NodePtr const Emplace( std::basic_string< CharTy > const& str, ArgsTy&&... args )
+  {
+    bool inserted { false };
+    bool created { false };
+    auto const node { EmplaceNode( str, inserted, created, std::forward< ArgsTy >( args )... ) };
+    if( node != nullptr && !created )
+    {
+      node->EmplaceData( std::forward< ArgsTy >( args )... );
+    }
+    return node;
+  }
+
+  // Inserts str with data built from args only if it is not already an
+  // entry, returns its node and whether it was inserted
+  template< typename... ArgsTy >
+  std::pair< NodePtr, bool > const TryEmplace( std::basic_string< CharTy > const& str, ArgsTy&&... args )
+  {
+    bool inserted { false };
+    bool created { false };
+    auto const node { EmplaceNode( str, inserted, created, std::forward< ArgsTy >( args )... ) };
+    if( inserted && !created )
+    {
+      node->EmplaceData( std::forward< ArgsTy >( args )... );
+    }
+    return { node, inserted };
+  }
+
+private:
+  // Inserts str in one walk, building the data from args only if its node is
+  // created. args are left untouched otherwise.
+  template< typename... ArgsTy >
+  NodePtr const EmplaceNode( std::basic_string< CharTy > const& str, bool& inserted, bool& created, ArgsTy&&... args )
+  {
+    auto& arena { this->m_arena };
+    return NodeTy::InsertEntry( this->m_root, str.begin(), str.end(), arena, inserted, [&]( auto&& key )
+    {
+      created = true;
+      return arena.Create( std::forward< decltype( key ) >( key ), typename NodeTy::EmplaceTag {}, std::forward< ArgsTy >( args )... );
+    } );
+  }
+};
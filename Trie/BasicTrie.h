@@ -16,16 +16,29 @@
 
 #pragma once
 #include "TrieNode.h"
+#include "TrieIterator.h"
 
 template< typename NodeTy, typename CharTy >
 class BasicTrie
 {
 public:
+  typedef typename NodeTy::Allocator Allocator;
+  typedef typename Allocator::template Pointer< NodeTy > NodePtr;
+  typedef typename Allocator::template Arena< NodeTy > NodeArena;
+  typedef TrieIterator< NodeTy, CharTy > Iterator;
+
+  struct FuzzyMatch
+  {
+    std::basic_string< CharTy > key;
+    NodePtr node;
+    size_t distance;
+  };
+
   #pragma region Constructors
   BasicTrie()
-    : m_root { std::make_shared< NodeTy >() }
+    : m_arena {}, m_root { m_arena.Create() }
   {
-    static_assert( std::is_base_of< TrieNode< CharTy >, NodeTy >::value, "Must use a TrieNode type" );
+    static_assert( std::is_base_of< TrieNode< CharTy, Allocator, typename NodeTy::Alphabet, typename NodeTy::Instrumentation >, NodeTy >::value, "Must use a TrieNode type" );
   }
 
   BasicTrie( const BasicTrie& rhs )
@@ -46,7 +59,10 @@ public:
   {
     if( &rhs != this )
     {
-      m_root = NodeTy::CloneSubTrie( rhs.m_root );
+      NodeArena arena;
+      auto root { NodeTy::CloneSubTrie( rhs.m_root, arena ) };
+      m_arena = std::move( arena );
+      m_root = std::move( root );
     }
     return *this;
   }
@@ -55,56 +71,214 @@ public:
   {
     if( &rhs != this )
     {
+      m_arena = std::move( rhs.m_arena );
       m_root = std::move( rhs.m_root );
+      rhs.m_root = nullptr;
     }
     return *this;
   }
   #pragma endregion
 
-  std::shared_ptr< NodeTy > const Insert( std::basic_string< CharTy > str )
+  NodePtr const Insert( std::basic_string< CharTy > const& str )
+  {
+    return NodeTy::Insert( m_root, str.begin(), str.end(), m_arena );
+  }
+
+  // Null terminated keys, used in place without building a string
+  NodePtr const Insert( CharTy const* const str )
   {
-    return NodeTy::Insert( m_root, str.begin(), str.end() );
+    return NodeTy::Insert( m_root, &str[0], &str[std::char_traits< CharTy >::length( str )], m_arena );
   }
 
   template< typename IterTy >
-  std::shared_ptr< NodeTy > const Insert( IterTy&& begin, IterTy&& end )
+  NodePtr const Insert( IterTy&& begin, IterTy&& end )
+  {
+    return NodeTy::Insert( m_root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ), m_arena );
+  }
+
+  NodePtr const Remove( std::basic_string< CharTy > const& str )
   {
-    return NodeTy::Insert( m_root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ) );
+    return NodeTy::Remove( m_root, str.begin(), str.end(), m_arena );
   }
 
-  std::shared_ptr< NodeTy > const Remove( std::basic_string< CharTy > str )
+  NodePtr const Remove( CharTy const* const str )
   {
-    return NodeTy::Remove( m_root, str.begin(), str.end() );
+    return NodeTy::Remove( m_root, &str[0], &str[std::char_traits< CharTy >::length( str )], m_arena );
   }
 
   template< typename IterTy >
-  std::shared_ptr< NodeTy > const Remove( IterTy&& begin, IterTy&& end )
+  NodePtr const Remove( IterTy&& begin, IterTy&& end )
   {
-    return NodeTy::Remove( m_root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ) );
+    return NodeTy::Remove( m_root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ), m_arena );
   }
 
-  std::shared_ptr< NodeTy > const Find( std::basic_string< CharTy > str ) const
+  NodePtr const Find( std::basic_string< CharTy > const& str ) const
   {
     return Find( str.begin(), str.end() );
   }
 
+  NodePtr const Find( CharTy const* const str ) const
+  {
+    return Find( &str[0], &str[std::char_traits< CharTy >::length( str )] );
+  }
+
   template< typename IterTy >
-  std::shared_ptr< NodeTy > const Find( IterTy&& begin, IterTy&& end ) const
+  NodePtr const Find( IterTy&& begin, IterTy&& end ) const
   {
     return NodeTy::Find( m_root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ) );
   }
 
-  bool const HasString( std::basic_string< CharTy > str ) const
+  bool const HasString( std::basic_string< CharTy > const& str ) const
   {
     return HasString( str.begin(), str.end() );
   }
 
+  bool const HasString( CharTy const* const str ) const
+  {
+    return HasString( &str[0], &str[std::char_traits< CharTy >::length( str )] );
+  }
+
   template< typename IterTy >
   bool const HasString( IterTy&& begin, IterTy&& end ) const
   {
     return NodeTy::HasString( m_root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ) );
   }
 
+  // Finds every string in strs, nodes[i] is the node of strs[i] or nullptr.
+  // Faster than a loop of Find for many lookups as the walks are interleaved.
+  void FindBatch( std::vector< std::basic_string< CharTy > > const& strs, std::vector< NodePtr >& nodes ) const
+  {
+    nodes.assign( strs.size(), NodePtr() );
+    NodeTy::FindBatch( m_root, strs.begin(), strs.end(), [&nodes]( size_t const i, typename NodeTy::NodePtr const* const link )
+    {
+      if( link != nullptr )
+      {
+        nodes[i] = Allocator::template Cast< NodeTy >( *link );
+      }
+    } );
+  }
+
+  std::vector< NodePtr > const FindBatch( std::vector< std::basic_string< CharTy > > const& strs ) const
+  {
+    std::vector< NodePtr > nodes;
+    FindBatch( strs, nodes );
+    return nodes;
+  }
+
+  void HasStringBatch( std::vector< std::basic_string< CharTy > > const& strs, std::vector< bool >& hasStrings ) const
+  {
+    hasStrings.assign( strs.size(), false );
+    NodeTy::FindBatch( m_root, strs.begin(), strs.end(), [&hasStrings]( size_t const i, typename NodeTy::NodePtr const* const link )
+    {
+      hasStrings[i] = link != nullptr;
+    } );
+  }
+
+  std::vector< bool > const HasStringBatch( std::vector< std::basic_string< CharTy > > const& strs ) const
+  {
+    std::vector< bool > hasStrings;
+    HasStringBatch( strs, hasStrings );
+    return hasStrings;
+  }
+
+  // The longest entry which is a prefix of str, as its length and node, or
+  // ( 0, nullptr ) if there is none
+  std::pair< size_t, NodePtr > const LongestPrefixOf( std::basic_string< CharTy > const& str ) const
+  {
+    return LongestPrefixOf( str.begin(), str.end() );
+  }
+
+  template< typename IterTy >
+  std::pair< size_t, NodePtr > const LongestPrefixOf( IterTy&& begin, IterTy&& end ) const
+  {
+    std::pair< size_t, NodePtr > longest { 0ULL, NodePtr() };
+    ForEachPrefixOf( std::forward< IterTy >( begin ), std::forward< IterTy >( end ), [&longest]( size_t const length, NodePtr const& node )
+    {
+      longest = { length, node };
+    } );
+    return longest;
+  }
+
+  // Calls fn( length, node ) for every entry which is a prefix of str,
+  // shortest first
+  template< typename FnTy >
+  void ForEachPrefixOf( std::basic_string< CharTy > const& str, FnTy&& fn ) const
+  {
+    ForEachPrefixOf( str.begin(), str.end(), std::forward< FnTy >( fn ) );
+  }
+
+  template< typename IterTy, typename FnTy >
+  void ForEachPrefixOf( IterTy&& begin, IterTy&& end, FnTy&& fn ) const
+  {
+    NodeTy::ForEachPrefixOf( m_root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ), [&fn]( size_t const length, typename NodeTy::NodePtr const& link )
+    {
+      fn( length, Allocator::template Cast< NodeTy >( link ) );
+    } );
+  }
+
+  // Every entry within maxDistance insertions, deletions or substitutions
+  // of query, in key order, stopping after maxResults matches
+  void FuzzyFind( std::basic_string< CharTy > const& query, size_t const maxDistance, std::vector< FuzzyMatch >& matches,
+                  size_t const maxResults = std::numeric_limits< size_t >::max() ) const
+  {
+    if( maxResults == 0ULL )
+    {
+      return;
+    }
+    size_t numResults { 0ULL };
+    NodeTy::FuzzyFind( m_root, query, maxDistance, [&]( std::basic_string< CharTy > const& key, typename NodeTy::NodePtr const& link, size_t const distance )
+    {
+      matches.push_back( { key, Allocator::template Cast< NodeTy >( link ), distance } );
+      return ++numResults < maxResults;
+    } );
+  }
+
+  std::vector< FuzzyMatch > const FuzzyFind( std::basic_string< CharTy > const& query, size_t const maxDistance,
+                                             size_t const maxResults = std::numeric_limits< size_t >::max() ) const
+  {
+    std::vector< FuzzyMatch > matches;
+    FuzzyFind( query, maxDistance, matches, maxResults );
+    return matches;
+  }
+
+  // Every entry matching the glob style pattern, in key order, see TriePattern
+  void Match( std::basic_string< CharTy > const& pattern, std::vector< typename NodeTy::Pair >& stringsWithNodes ) const
+  {
+    NodeTy::Match( m_root, TriePattern< CharTy >( pattern ), [&stringsWithNodes]( std::basic_string< CharTy > const& key, typename NodeTy::NodePtr const& link )
+    {
+      stringsWithNodes.push_back( { key, Allocator::template Cast< NodeTy >( link ) } );
+    } );
+  }
+
+  std::vector< typename NodeTy::Pair > const Match( std::basic_string< CharTy > const& pattern ) const
+  {
+    std::vector< typename NodeTy::Pair > stringsWithNodes;
+    Match( pattern, stringsWithNodes );
+    return stringsWithNodes;
+  }
+
+  // Counting queries, only for nodes which count their entries such as
+  // CountedTrieNode. Each walks one path.
+  size_t const CountPrefix( std::basic_string< CharTy > const& prefix ) const
+  {
+    return NodeTy::CountPrefix( m_root, prefix.begin(), prefix.end() );
+  }
+
+  // Number of entries before str in key order
+  size_t const Rank( std::basic_string< CharTy > const& str ) const
+  {
+    return NodeTy::Rank( m_root, str.begin(), str.end() );
+  }
+
+  // The index-th entry in key order, or an empty key and nullptr if there
+  // are not that many entries
+  typename NodeTy::Pair const Select( size_t const index ) const
+  {
+    std::basic_string< CharTy > key;
+    auto const link { NodeTy::Select( m_root, index, key ) };
+    return { key, ( link == nullptr ) ? NodePtr() : Allocator::template Cast< NodeTy >( *link ) };
+  }
+
   void GetAllStrings( std::vector< std::basic_string< CharTy > >& strings ) const
   {
     if( m_root != nullptr )
@@ -122,7 +296,10 @@ public:
 
   void GetAllStringsWithNodes( std::vector< typename NodeTy::Pair >& stringsWithNodes ) const
   {
-    NodeTy::GetAllStringsWithNodes( m_root, stringsWithNodes );
+    if( m_root != nullptr )
+    {
+      NodeTy::GetAllStringsWithNodes( m_root, stringsWithNodes );
+    }
   }
 
   std::vector< typename NodeTy::Pair > const GetAllStringsWithNodes() const
@@ -132,6 +309,150 @@ public:
     return stringsWithNodes;
   }
 
+  #pragma region Iteration
+  // Iterators are invalidated by any change to the trie
+  Iterator const Begin() const
+  {
+    return Iterator::LowerBound( m_root, std::basic_string< CharTy > {} );
+  }
+
+  Iterator const End() const
+  {
+    return Iterator();
+  }
+
+  Iterator const begin() const
+  {
+    return Begin();
+  }
+
+  Iterator const end() const
+  {
+    return End();
+  }
+
+  // The first entry not less than str
+  Iterator const LowerBound( std::basic_string< CharTy > const& str ) const
+  {
+    return Iterator::LowerBound( m_root, str );
+  }
+
+  // Every entry starting with prefix, in order
+  TrieRange< Iterator > const PrefixRange( std::basic_string< CharTy > const& prefix ) const
+  {
+    return { Iterator::LowerBound( m_root, prefix, prefix.size() ), End() };
+  }
+  #pragma endregion
+
+  // Node, entry, memory and shape statistics, walking every node once
+  void GetStats( TrieStats& stats ) const
+  {
+    NodeTy::GetStats( m_root, stats );
+  }
+
+  TrieStats const GetStats() const
+  {
+    TrieStats stats;
+    GetStats( stats );
+    return stats;
+  }
+
+  // Counted as the trie changes, only with CountingNodeAllocator. The root
+  // is one of the nodes.
+  size_t const GetNumNodes() const
+  {
+    return m_arena.GetNumNodes();
+  }
+
+  size_t const GetNumEntries() const
+  {
+    return m_arena.GetNumEntries();
+  }
+
+  NodePtr const& GetRoot() const
+  {
+    return m_root;
+  }
+
 protected:
-  std::shared_ptr< NodeTy > m_root;
+  NodeArena m_arena;
+  NodePtr m_root;
+
+  // Inserts keyOf( *it ) for every element of [first, last), calling
+  // onEntry( node, *it ) for each. Each key starts from the node where it
+  // leaves the previous key, so a shared prefix is never walked twice. When
+  // the trie is empty and the input sorted, a counting pass first sizes every
+  // node's children so the build pass never looks up or regrows a child table.
+  // Elements are held for the whole step and the previous key is kept as a
+  // copy, so keyOf may return a temporary and the iterator may yield them.
+  template< typename IterTy, typename KeyFnTy, typename EntryFnTy >
+  void InsertSorted( IterTy const& first, IterTy const& last, KeyFnTy&& keyOf, EntryFnTy&& onEntry )
+  {
+    // numChildren[n] is the child count of the n-th node created, root first
+    auto sorted { m_root->GetNumChildren() == 0ULL };
+    std::vector< size_t > numChildren { 0ULL };
+    std::vector< size_t > pathNodes { 0ULL };
+    std::basic_string< CharTy > prevKey;
+    for( auto it { first }; sorted && it != last; ++it )
+    {
+      auto&& element { *it };
+      auto const& key { keyOf( element ) };
+      if( key.empty() || !NodeTy::InAlphabet( key.begin(), key.end() ) )
+      {
+        continue;
+      }
+      if( key < prevKey )
+      {
+        sorted = false;
+        break;
+      }
+
+      pathNodes.resize( SharedLength( prevKey, key ) + 1ULL );
+      for( auto depth { pathNodes.size() - 1ULL }; depth < key.size(); ++depth )
+      {
+        ++numChildren[pathNodes.back()];
+        pathNodes.push_back( numChildren.size() );
+        numChildren.push_back( 0ULL );
+      }
+      prevKey.assign( key.begin(), key.end() );
+    }
+
+    std::vector< NodeTy* > path { Allocator::Raw( m_root ) };
+    if( sorted )
+    {
+      path.front()->ReserveChildren( numChildren.front() );
+    }
+
+    auto nextNumChildren { numChildren.cbegin() + 1 };
+    prevKey.clear();
+    for( auto it { first }; it != last; ++it )
+    {
+      auto&& element { *it };
+      auto const& key { keyOf( element ) };
+      if( key.empty() || !NodeTy::InAlphabet( key.begin(), key.end() ) )
+      {
+        continue;
+      }
+
+      auto const sharedLength { SharedLength( prevKey, key ) };
+      path.resize( sharedLength + 1ULL );
+      auto const suffix { key.begin() + static_cast< std::ptrdiff_t >( sharedLength ) };
+      auto const node { sorted ? NodeTy::AppendBelow( path, suffix, key.end(), m_arena, nextNumChildren )
+                               : NodeTy::InsertBelow( path, suffix, key.end(), m_arena ) };
+      onEntry( *node, element );
+      prevKey.assign( key.begin(), key.end() );
+    }
+  }
+
+private:
+  static size_t const SharedLength( std::basic_string< CharTy > const& prevKey, std::basic_string< CharTy > const& key )
+  {
+    size_t sharedLength { 0ULL };
+    auto const maxShared { std::min( key.size(), prevKey.size() ) };
+    while( sharedLength < maxShared && prevKey[sharedLength] == key[sharedLength] )
+    {
+      ++sharedLength;
+    }
+    return sharedLength;
+  }
 };
\ No newline at end of file
@@ -0,0 +1,219 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+// Append-only bit vector with rank/select support once Build() is called.
+// Rank is sampled every BlockWords words, select every SelectSample bits.
+class BitVector
+{
+public:
+  static constexpr size_t WordBits = 64ULL;
+  static constexpr size_t BlockWords = 8ULL;
+  static constexpr size_t SelectSample = 512ULL;
+
+  #pragma region Constructors
+  BitVector()
+    : m_size { 0ULL }, m_numOnes { 0ULL }
+  {
+
+  }
+  #pragma endregion
+
+  #pragma region Getters
+  size_t const Size() const
+  {
+    return m_size;
+  }
+
+  size_t const NumOnes() const
+  {
+    return m_numOnes;
+  }
+
+  size_t const NumZeros() const
+  {
+    return m_size - m_numOnes;
+  }
+
+  bool const Get( size_t const pos ) const
+  {
+    return ( m_words[pos / WordBits] >> ( pos % WordBits ) ) & 1ULL;
+  }
+
+  // Number of set bits in [0, pos)
+  size_t const Rank1( size_t const pos ) const
+  {
+    auto const word { pos / WordBits };
+    auto const block { word / BlockWords };
+    size_t rank { m_ranks[block] };
+    for( size_t i { block * BlockWords }; i < word; ++i )
+    {
+      rank += PopCount( m_words[i] );
+    }
+    auto const bit { pos % WordBits };
+    if( bit != 0ULL )
+    {
+      rank += PopCount( m_words[word] & ( ( 1ULL << bit ) - 1ULL ) );
+    }
+    return rank;
+  }
+
+  size_t const Rank0( size_t const pos ) const
+  {
+    return pos - Rank1( pos );
+  }
+
+  // Position of the k-th (0-based) set bit
+  size_t const Select1( size_t const k ) const
+  {
+    return Select< true >( k, m_select1 );
+  }
+
+  // Position of the k-th (0-based) clear bit
+  size_t const Select0( size_t const k ) const
+  {
+    return Select< false >( k, m_select0 );
+  }
+
+  size_t const GetSizeInBytes() const
+  {
+    return m_words.size() * sizeof( uint64_t ) + m_ranks.size() * sizeof( uint32_t )
+         + ( m_select0.size() + m_select1.size() ) * sizeof( uint32_t );
+  }
+
+  std::vector< uint64_t > const& GetWords() const
+  {
+    return m_words;
+  }
+  #pragma endregion
+
+  #pragma region Modifiers
+  void PushBack( bool const bit )
+  {
+    if( m_size % WordBits == 0ULL )
+    {
+      m_words.push_back( 0ULL );
+    }
+    if( bit )
+    {
+      m_words.back() |= 1ULL << ( m_size % WordBits );
+      ++m_numOnes;
+    }
+    ++m_size;
+  }
+
+  // Computes the rank and select samples, must be called before querying
+  void Build()
+  {
+    m_ranks.assign( m_words.size() / BlockWords + 1ULL, 0U );
+    m_select0.clear();
+    m_select1.clear();
+
+    size_t ones { 0ULL };
+    size_t zeros { 0ULL };
+    for( size_t i { 0ULL }; i < m_words.size(); ++i )
+    {
+      if( i % BlockWords == 0ULL )
+      {
+        m_ranks[i / BlockWords] = static_cast< uint32_t >( ones );
+      }
+
+      auto const remainingBits { m_size - i * WordBits };
+      auto const bitsInWord { ( remainingBits < WordBits ) ? remainingBits : WordBits };
+      auto const wordOnes { PopCount( m_words[i] ) };
+      auto const wordZeros { bitsInWord - wordOnes };
+
+      // remember the word holding every SelectSample-th bit of each kind
+      while( m_select1.size() * SelectSample < ones + wordOnes )
+      {
+        m_select1.push_back( static_cast< uint32_t >( i ) );
+      }
+      while( m_select0.size() * SelectSample < zeros + wordZeros )
+      {
+        m_select0.push_back( static_cast< uint32_t >( i ) );
+      }
+
+      ones += wordOnes;
+      zeros += wordZeros;
+    }
+    if( m_words.size() % BlockWords == 0ULL )
+    {
+      m_ranks.back() = static_cast< uint32_t >( ones );
+    }
+  }
+  #pragma endregion
+
+  static size_t const PopCount( uint64_t const word )
+  {
+#if defined( __GNUC__ ) || defined( __clang__ )
+    return static_cast< size_t >( __builtin_popcountll( word ) );
+#else
+    auto x { word - ( ( word >> 1 ) & 0x5555555555555555ULL ) };
+    x = ( x & 0x3333333333333333ULL ) + ( ( x >> 2 ) & 0x3333333333333333ULL );
+    x = ( x + ( x >> 4 ) ) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast< size_t >( ( x * 0x0101010101010101ULL ) >> 56 );
+#endif
+  }
+
+private:
+  std::vector< uint64_t > m_words;
+  std::vector< uint32_t > m_ranks;
+  std::vector< uint32_t > m_select0;
+  std::vector< uint32_t > m_select1;
+  size_t m_size;
+  size_t m_numOnes;
+
+  template< bool Bit >
+  size_t const Select( size_t k, std::vector< uint32_t > const& samples ) const
+  {
+    size_t word { samples[k / SelectSample] };
+    size_t count { Bit ? Rank1( word * WordBits ) : Rank0( word * WordBits ) };
+    while( true )
+    {
+      auto const bits { Bit ? m_words[word] : ~m_words[word] };
+      auto const wordCount { PopCount( bits ) };
+      if( count + wordCount > k )
+      {
+        return word * WordBits + SelectInWord( bits, k - count );
+      }
+      count += wordCount;
+      ++word;
+    }
+  }
+
+  static size_t const SelectInWord( uint64_t bits, size_t k )
+  {
+    for( size_t i { 0ULL }; i < k; ++i )
+    {
+      bits &= bits - 1ULL;
+    }
+#if defined( __GNUC__ ) || defined( __clang__ )
+    return static_cast< size_t >( __builtin_ctzll( bits ) );
+#else
+    size_t pos { 0ULL };
+    while( ( bits & 1ULL ) == 0ULL )
+    {
+      bits >>= 1;
+      ++pos;
+    }
+    return pos;
+#endif
+  }
+};
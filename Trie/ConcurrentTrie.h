@@ -0,0 +1,389 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ConcurrentTrieNode.h"
+#include "EpochManager.h"
+
+// Trie safe for any mix of concurrent Insert, Remove and HasString calls.
+// Traversals use optimistic lock coupling: nodes are read without locking and
+// the walk restarts if a version check fails. Writers only lock the node they
+// change, and unlinked nodes and child tables are freed through epochs.
+template< typename CharTy >
+class ConcurrentTrie
+{
+public:
+  typedef ConcurrentTrieNode< CharTy > NodeTy;
+
+  #pragma region Constructors
+  ConcurrentTrie()
+    : m_root { new NodeTy() }
+  {
+
+  }
+
+  ConcurrentTrie( ConcurrentTrie const& ) = delete;
+
+  ~ConcurrentTrie()
+  {
+    std::vector< NodeTy* > pending { m_root };
+    while( !pending.empty() )
+    {
+      auto const node { pending.back() };
+      pending.pop_back();
+      node->ForEachChild( [&pending]( NodeTy* const child )
+      {
+        pending.push_back( child );
+      } );
+      delete node;
+    }
+  }
+  #pragma endregion
+
+  #pragma region Operator Overrides
+  ConcurrentTrie& operator=( ConcurrentTrie const& ) = delete;
+  #pragma endregion
+
+  // Returns false if str was already in the trie
+  bool const Insert( std::basic_string< CharTy > const& str )
+  {
+    return Insert( str.begin(), str.end() );
+  }
+
+  template< typename IterTy >
+  bool const Insert( IterTy&& begin, IterTy&& end )
+  {
+    return Run( [this, &begin, &end]()
+    {
+      return TryInsert( begin, end );
+    } );
+  }
+
+  // Returns false if str was not in the trie
+  bool const Remove( std::basic_string< CharTy > const& str )
+  {
+    return Remove( str.begin(), str.end() );
+  }
+
+  template< typename IterTy >
+  bool const Remove( IterTy&& begin, IterTy&& end )
+  {
+    bool unlinked { true };
+    auto const removed { Run( [this, &begin, &end, &unlinked]()
+    {
+      return TryRemove( begin, end, unlinked );
+    } ) };
+    if( !unlinked )
+    {
+      Run( [this, &begin, &end]()
+      {
+        return TryUnlink( begin, end );
+      } );
+    }
+    return removed;
+  }
+
+  bool const HasString( std::basic_string< CharTy > const& str ) const
+  {
+    return HasString( str.begin(), str.end() );
+  }
+
+  template< typename IterTy >
+  bool const HasString( IterTy&& begin, IterTy&& end ) const
+  {
+    return Run( [this, &begin, &end]()
+    {
+      return TryFind( begin, end );
+    } );
+  }
+
+  // Entries present for the whole call are always included, entries inserted
+  // or removed concurrently may or may not be
+  void GetAllStrings( std::vector< std::basic_string< CharTy > >& strings ) const
+  {
+    auto const guard { m_epochs.Enter() };
+    std::vector< std::pair< NodeTy const*, size_t > > pending;
+    m_root->ForEachChild( [&pending]( NodeTy const* const child )
+    {
+      pending.push_back( { child, 0ULL } );
+    } );
+    std::reverse( pending.begin(), pending.end() );
+
+    std::basic_string< CharTy > str;
+    while( !pending.empty() )
+    {
+      auto const node { pending.back().first };
+      auto const depth { pending.back().second };
+      pending.pop_back();
+
+      str.resize( depth );
+      str.push_back( node->GetChar() );
+      if( node->IsEndOfAnEntry() )
+      {
+        strings.push_back( str );
+      }
+
+      auto const numPending { pending.size() };
+      node->ForEachChild( [&pending, depth]( NodeTy const* const child )
+      {
+        pending.push_back( { child, depth + 1ULL } );
+      } );
+      std::reverse( pending.begin() + static_cast< std::ptrdiff_t >( numPending ), pending.end() );
+    }
+  }
+
+  std::vector< std::basic_string< CharTy > > const GetAllStrings() const
+  {
+    std::vector< std::basic_string< CharTy > > strings;
+    GetAllStrings( strings );
+    return strings;
+  }
+
+  size_t const GetNumNodes() const
+  {
+    auto const guard { m_epochs.Enter() };
+    size_t numNodes { 0ULL };
+    std::vector< NodeTy const* > pending { m_root };
+    while( !pending.empty() )
+    {
+      auto const node { pending.back() };
+      pending.pop_back();
+      ++numNodes;
+      node->ForEachChild( [&pending]( NodeTy const* const child )
+      {
+        pending.push_back( child );
+      } );
+    }
+    return numNodes;
+  }
+
+private:
+  enum class Outcome
+  {
+    Restart,
+    False,
+    True
+  };
+
+  mutable EpochManager m_epochs;
+  NodeTy* const m_root;
+
+  template< typename FnTy >
+  bool const Run( FnTy&& attempt ) const
+  {
+    auto const guard { m_epochs.Enter() };
+    while( true )
+    {
+      auto const outcome { attempt() };
+      if( outcome != Outcome::Restart )
+      {
+        return outcome == Outcome::True;
+      }
+    }
+  }
+
+  template< typename IterTy >
+  Outcome const TryFind( IterTy const& begin, IterTy const& end ) const
+  {
+    bool restart { false };
+    NodeTy const* node { m_root };
+    auto version { node->ReadLock( restart ) };
+    if( restart || begin == end )
+    {
+      return restart ? Outcome::Restart : Outcome::False;
+    }
+
+    for( auto it { begin }; it != end; ++it )
+    {
+      auto const child { node->GetChild( *it ) };
+      if( !node->Validate( version ) )
+      {
+        return Outcome::Restart;
+      }
+      if( child == nullptr )
+      {
+        return Outcome::False;
+      }
+
+      version = child->ReadLock( restart );
+      if( restart )
+      {
+        return Outcome::Restart;
+      }
+      node = child;
+    }
+
+    auto const isEndOfAnEntry { node->IsEndOfAnEntry() };
+    if( !node->Validate( version ) )
+    {
+      return Outcome::Restart;
+    }
+    return isEndOfAnEntry ? Outcome::True : Outcome::False;
+  }
+
+  template< typename IterTy >
+  Outcome const TryInsert( IterTy const& begin, IterTy const& end )
+  {
+    bool restart { false };
+    NodeTy* node { m_root };
+    auto version { node->ReadLock( restart ) };
+    if( restart || begin == end )
+    {
+      return restart ? Outcome::Restart : Outcome::False;
+    }
+
+    for( auto it { begin }; it != end; ++it )
+    {
+      auto child { node->GetChild( *it ) };
+      if( child == nullptr )
+      {
+        if( !node->TryWriteLock( version ) )
+        {
+          return Outcome::Restart;
+        }
+        child = new NodeTy( *it );
+        m_epochs.Retire( node->AddChild( child ) );
+        node->WriteUnlock();
+      }
+      else if( !node->Validate( version ) )
+      {
+        return Outcome::Restart;
+      }
+
+      version = child->ReadLock( restart );
+      if( restart )
+      {
+        return Outcome::Restart;
+      }
+      node = child;
+    }
+
+    if( !node->TryWriteLock( version ) )
+    {
+      return Outcome::Restart;
+    }
+    auto const inserted { !node->IsEndOfAnEntry() };
+    node->SetEndOfAnEntry( true );
+    node->WriteUnlock();
+    return inserted ? Outcome::True : Outcome::False;
+  }
+
+  using Path = std::vector< std::pair< NodeTy*, uint64_t > >;
+
+  template< typename IterTy >
+  Outcome const ReadPath( IterTy const& begin, IterTy const& end, Path& path )
+  {
+    bool restart { false };
+    path.assign( { { m_root, m_root->ReadLock( restart ) } } );
+    if( restart || begin == end )
+    {
+      return restart ? Outcome::Restart : Outcome::False;
+    }
+
+    for( auto it { begin }; it != end; ++it )
+    {
+      auto const node { path.back().first };
+      auto const child { node->GetChild( *it ) };
+      if( !node->Validate( path.back().second ) )
+      {
+        return Outcome::Restart;
+      }
+      if( child == nullptr )
+      {
+        return Outcome::False;
+      }
+
+      path.push_back( { child, child->ReadLock( restart ) } );
+      if( restart )
+      {
+        return Outcome::Restart;
+      }
+    }
+    return Outcome::True;
+  }
+
+  // Unlinks the branch left without entries above the write locked leaf of
+  // path and unlocks it, returns false if a parent changed before it could be
+  // locked
+  bool const UnlinkEmptyBranch( Path const& path )
+  {
+    auto i { path.size() - 1ULL };
+    while( i > 0ULL && path[i].first->GetNumChildren() == 0ULL && !path[i].first->IsEndOfAnEntry() )
+    {
+      auto const parent { path[i - 1ULL].first };
+      if( !parent->TryWriteLock( path[i - 1ULL].second ) )
+      {
+        path[i].first->WriteUnlock();
+        return false;
+      }
+      m_epochs.Retire( parent->RemoveChild( path[i].first->GetChar() ) );
+      path[i].first->WriteUnlockObsolete();
+      m_epochs.Retire( path[i].first );
+      --i;
+    }
+    path[i].first->WriteUnlock();
+    return true;
+  }
+
+  template< typename IterTy >
+  Outcome const TryRemove( IterTy const& begin, IterTy const& end, bool& unlinked )
+  {
+    Path path;
+    auto const outcome { ReadPath( begin, end, path ) };
+    if( outcome != Outcome::True )
+    {
+      return outcome;
+    }
+
+    auto const leaf { path.back().first };
+    if( !leaf->TryWriteLock( path.back().second ) )
+    {
+      return Outcome::Restart;
+    }
+    if( !leaf->IsEndOfAnEntry() )
+    {
+      leaf->WriteUnlock();
+      return Outcome::False;
+    }
+    leaf->SetEndOfAnEntry( false );
+
+    // the entry is gone either way, a failed unlink is redone by TryUnlink
+    unlinked = UnlinkEmptyBranch( path );
+    return Outcome::True;
+  }
+
+  // Retries unlinking the empty branch along the key from its deepest node
+  // still linked, does nothing if the key was reinserted
+  template< typename IterTy >
+  Outcome const TryUnlink( IterTy const& begin, IterTy const& end )
+  {
+    Path path;
+    if( ReadPath( begin, end, path ) == Outcome::Restart )
+    {
+      return Outcome::Restart;
+    }
+
+    if( !path.back().first->TryWriteLock( path.back().second ) )
+    {
+      return Outcome::Restart;
+    }
+    return UnlinkEmptyBranch( path ) ? Outcome::True : Outcome::Restart;
+  }
+};
@@ -0,0 +1,167 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include "TrieNodeChildren.h"
+
+// Trie node guarded by an optimistic lock. The version word holds a change
+// counter with LockedBit set while a writer owns the node and ObsoleteBit set
+// once it is unlinked. Readers never write the node: they record the version,
+// read, and restart if the version changed. Child tables are immutable once
+// published, writers replace the whole table under the lock.
+template< typename CharTy >
+class ConcurrentTrieNode
+{
+public:
+  static constexpr size_t NumChars = 1ULL << 8ULL * sizeof( CharTy );
+  static constexpr uint64_t ObsoleteBit = 1ULL;
+  static constexpr uint64_t LockedBit = 2ULL;
+  typedef TrieNodeChildren< ConcurrentTrieNode*, NumChars > Children;
+
+  #pragma region Constructors
+  explicit ConcurrentTrieNode( CharTy const charVal )
+    : m_char { charVal }, m_isEndOfAnEntry { false }, m_version { 0ULL }, m_children { new Children() }
+  {
+    static_assert( std::is_integral< CharTy >::value, "Must use an integral type for CharTy" );
+  }
+
+  ConcurrentTrieNode()
+    : ConcurrentTrieNode( static_cast< CharTy >( 0 ) )
+  {
+
+  }
+
+  ConcurrentTrieNode( ConcurrentTrieNode const& ) = delete;
+
+  ~ConcurrentTrieNode()
+  {
+    delete m_children.load( std::memory_order_relaxed );
+  }
+  #pragma endregion
+
+  #pragma region Operator Overrides
+  ConcurrentTrieNode& operator=( ConcurrentTrieNode const& ) = delete;
+  #pragma endregion
+
+  #pragma region Optimistic Lock
+  // Waits out any writer and returns the version to validate against, sets
+  // restart if the node has been unlinked
+  uint64_t const ReadLock( bool& restart ) const
+  {
+    auto version { m_version.load() };
+    while( ( version & LockedBit ) != 0ULL )
+    {
+      std::this_thread::yield();
+      version = m_version.load();
+    }
+    restart = ( version & ObsoleteBit ) != 0ULL;
+    return version;
+  }
+
+  // Whether nothing was written since ReadLock returned version
+  bool const Validate( uint64_t const version ) const
+  {
+    return m_version.load() == version;
+  }
+
+  bool const TryWriteLock( uint64_t const version )
+  {
+    auto expected { version };
+    return m_version.compare_exchange_strong( expected, version + LockedBit );
+  }
+
+  void WriteUnlock()
+  {
+    m_version.fetch_add( LockedBit );
+  }
+
+  void WriteUnlockObsolete()
+  {
+    m_version.fetch_add( LockedBit + ObsoleteBit );
+  }
+  #pragma endregion
+
+  #pragma region Getters
+  CharTy const GetChar() const
+  {
+    return m_char;
+  }
+
+  bool const IsEndOfAnEntry() const
+  {
+    return m_isEndOfAnEntry.load();
+  }
+
+  ConcurrentTrieNode* GetChild( CharTy const c ) const
+  {
+    return m_children.load()->Get( CharIndex( c ) );
+  }
+
+  size_t const GetNumChildren() const
+  {
+    return m_children.load()->Size();
+  }
+
+  // Calls fn( child ) for every child in ascending character order
+  template< typename FnTy >
+  void ForEachChild( FnTy&& fn ) const
+  {
+    m_children.load()->ForEach( [&fn]( size_t const, ConcurrentTrieNode* const& child )
+    {
+      fn( child );
+    } );
+  }
+  #pragma endregion
+
+  #pragma region Modifiers
+  // The following require the write lock
+  void SetEndOfAnEntry( bool const isEndOfAnEntry )
+  {
+    m_isEndOfAnEntry.store( isEndOfAnEntry );
+  }
+
+  // Publishes a table with child added and returns the old one for retirement
+  Children* AddChild( ConcurrentTrieNode* const child )
+  {
+    auto const children { new Children( *m_children.load() ) };
+    children->Set( CharIndex( child->m_char ), child );
+    return m_children.exchange( children );
+  }
+
+  // Publishes a table without c and returns the old one for retirement
+  Children* RemoveChild( CharTy const c )
+  {
+    auto const children { new Children( *m_children.load() ) };
+    children->Remove( CharIndex( c ) );
+    return m_children.exchange( children );
+  }
+  #pragma endregion
+
+  static size_t const CharIndex( CharTy const c )
+  {
+    return static_cast< size_t >( static_cast< typename std::make_unsigned< CharTy >::type >( c ) );
+  }
+
+private:
+  CharTy const m_char;
+  std::atomic< bool > m_isEndOfAnEntry;
+  std::atomic< uint64_t > m_version;
+  std::atomic< Children* > m_children;
+};
@@ -0,0 +1,258 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <string>
+#include <type_traits>
+#include "TrieNode.h"
+
+// Node which also counts the entries at or below it, kept current by Insert
+// and Remove, so prefix counts, ranks and selects need only walk one path.
+// BaseNodeTy is TrieNode or DataTrieNode.
+template< typename CharTy, typename AllocTy = SharedNodeAllocator, typename BaseNodeTy = TrieNode< CharTy, AllocTy > >
+class CountedTrieNode : public BaseNodeTy
+{
+public:
+  typedef typename TrieNode< CharTy, AllocTy >::NodePtr NodePtr;
+  typedef std::pair < std::basic_string< CharTy >, typename AllocTy::template Pointer< CountedTrieNode< CharTy, AllocTy, BaseNodeTy > > const > Pair;
+
+  #pragma region Constructors
+  // args are passed on to BaseNodeTy after the character
+  template< typename... ArgsTy >
+  CountedTrieNode( CharTy const charVal, ArgsTy&&... args )
+    : BaseNodeTy( charVal, std::forward< ArgsTy >( args )... ), m_numEntries { 0ULL }
+  {
+
+  }
+
+  CountedTrieNode()
+    : CountedTrieNode( static_cast< CharTy >( 0 ) )
+  {
+
+  }
+  #pragma endregion
+
+  // Number of entries at or below this node
+  size_t const GetNumEntries() const
+  {
+    return m_numEntries;
+  }
+
+  #pragma region Static Operations
+  template< typename NodePtrTy, typename IterTy, typename ArenaTy >
+  static NodePtrTy const Insert( NodePtrTy const& root, IterTy&& begin, IterTy&& end, ArenaTy& arena )
+  {
+    bool inserted { false };
+    return InsertEntry( root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ), arena, inserted, [&arena]( CharTy const c )
+    {
+      return arena.Create( c );
+    } );
+  }
+
+  // Insert, creating the key's last node with createLast( c ) if it does not
+  // exist yet. inserted is set if the key was not already an entry. The
+  // nodes on the path are remembered on the way down and counted once the
+  // key is known to be new, keys too long to remember are walked again.
+  template< typename NodePtrTy, typename IterTy, typename ArenaTy, typename CreateTy >
+  static NodePtrTy const InsertEntry( NodePtrTy const& root, IterTy&& begin, IterTy&& end, ArenaTy& arena, bool& inserted, CreateTy&& createLast )
+  {
+    typedef typename TrieNode< CharTy, AllocTy >::template NodeOf< NodePtrTy > NodeTy;
+    typedef typename std::decay< IterTy >::type IterValTy;
+    inserted = false;
+    if( root == nullptr || begin == end || !TrieNode< CharTy, AllocTy >::InAlphabet( IterValTy { begin }, end ) )
+    {
+      return NodePtrTy();
+    }
+
+    CountedTrieNode* path[NumRememberedNodes];
+    size_t depth { 0ULL };
+    CountedTrieNode* curNode { AllocTy::Raw( root ) };
+    NodePtr const* curLink { nullptr };
+    for( IterValTy it { begin }; it != end; )
+    {
+      if( depth < NumRememberedNodes )
+      {
+        path[depth] = curNode;
+      }
+      ++depth;
+
+      auto const c { *it };
+      auto const isLast { ++it == end };
+      curLink = &curNode->GetChild( c );
+      if( *curLink == nullptr )
+      {
+        curNode->AddChild( isLast ? createLast( c ) : arena.Create( c ) );
+        curLink = &curNode->GetChild( c );
+      }
+      curNode = static_cast< CountedTrieNode* >( AllocTy::Raw( *curLink ) );
+    }
+
+    if( !curNode->IsEndOfAnEntry() )
+    {
+      inserted = true;
+      TrieNode< CharTy, AllocTy >::SetEndOfAnEntry( *curNode, true, arena );
+      if( depth <= NumRememberedNodes )
+      {
+        for( size_t i { 0ULL }; i < depth; ++i )
+        {
+          ++path[i]->m_numEntries;
+        }
+        ++curNode->m_numEntries;
+      }
+      else
+      {
+        AddAlongPath( root, IterValTy { begin }, end, 1LL );
+      }
+    }
+    return AllocTy::template Cast< NodeTy >( *curLink );
+  }
+
+  template< typename NodePtrTy, typename IterTy, typename DataTy, typename ArenaTy >
+  static NodePtrTy const Insert( NodePtrTy const& root, IterTy&& begin, IterTy&& end, DataTy&& data, ArenaTy& arena )
+  {
+    auto const node { Insert( root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ), arena ) };
+    if( node != nullptr )
+    {
+      node->SetData( std::forward< DataTy >( data ) );
+    }
+    return node;
+  }
+
+  template< typename NodePtrTy, typename IterTy, typename ArenaTy >
+  static NodePtrTy const Remove( NodePtrTy const& root, IterTy&& begin, IterTy&& end, ArenaTy& arena )
+  {
+    typedef typename std::decay< IterTy >::type IterValTy;
+    auto const node { TrieNode< CharTy, AllocTy >::Remove( root, IterValTy { begin }, IterValTy { end }, arena ) };
+    if( node != nullptr )
+    {
+      // every node left on the path held the removed entry
+      AddAlongPath( root, IterValTy { begin }, end, -1LL );
+    }
+    return node;
+  }
+
+  // Number of entries starting with [begin, end)
+  template< typename NodePtrTy, typename IterTy >
+  static size_t const CountPrefix( NodePtrTy const& root, IterTy begin, IterTy const& end )
+  {
+    if( root == nullptr )
+    {
+      return 0ULL;
+    }
+
+    CountedTrieNode const* node { AllocTy::Raw( root ) };
+    for( ; begin != end; ++begin )
+    {
+      auto const& link { node->GetChild( *begin ) };
+      if( link == nullptr )
+      {
+        return 0ULL;
+      }
+      node = static_cast< CountedTrieNode const* >( AllocTy::Raw( link ) );
+    }
+    return node->m_numEntries;
+  }
+
+  // Number of entries ordered before [begin, end), which need not be an entry
+  template< typename NodePtrTy, typename IterTy >
+  static size_t const Rank( NodePtrTy const& root, IterTy begin, IterTy const& end )
+  {
+    size_t rank { 0ULL };
+    CountedTrieNode const* node { ( root == nullptr ) ? nullptr : AllocTy::Raw( root ) };
+    for( ; node != nullptr && begin != end; ++begin )
+    {
+      // entries which are a proper prefix, then every smaller sibling subtree
+      rank += node->m_isEndOfAnEntry ? 1ULL : 0ULL;
+      auto const charIndex { TrieNode< CharTy, AllocTy >::CharIndex( *begin ) };
+      size_t nextIndex { 0ULL };
+      for( auto child { node->GetNextChild( nextIndex ) }; child != nullptr && nextIndex < charIndex; child = node->GetNextChild( ++nextIndex ) )
+      {
+        rank += static_cast< CountedTrieNode const* >( AllocTy::Raw( *child ) )->m_numEntries;
+      }
+
+      auto const& link { node->GetChild( *begin ) };
+      node = ( link == nullptr ) ? nullptr : static_cast< CountedTrieNode const* >( AllocTy::Raw( link ) );
+    }
+    return rank;
+  }
+
+  // The link to the index-th entry in key order, setting key to it, or
+  // nullptr if there are not that many entries
+  template< typename NodePtrTy >
+  static NodePtr const* Select( NodePtrTy const& root, size_t index, std::basic_string< CharTy >& key )
+  {
+    key.clear();
+    if( root == nullptr || index >= root->m_numEntries )
+    {
+      return nullptr;
+    }
+
+    CountedTrieNode const* node { AllocTy::Raw( root ) };
+    NodePtr const* link { nullptr };
+    for( ;; )
+    {
+      if( node->m_isEndOfAnEntry )
+      {
+        if( index == 0ULL )
+        {
+          return link;
+        }
+        --index;
+      }
+
+      size_t charIndex { 0ULL };
+      for( auto child { node->GetNextChild( charIndex ) }; child != nullptr; child = node->GetNextChild( ++charIndex ) )
+      {
+        auto const childNode { static_cast< CountedTrieNode const* >( AllocTy::Raw( *child ) ) };
+        if( index < childNode->m_numEntries )
+        {
+          key.push_back( childNode->m_char );
+          link = child;
+          node = childNode;
+          break;
+        }
+        index -= childNode->m_numEntries;
+      }
+    }
+  }
+  #pragma endregion
+
+private:
+  static constexpr size_t NumRememberedNodes = 32ULL;
+
+  size_t m_numEntries;
+
+  template< typename NodePtrTy, typename IterTy >
+  static void AddAlongPath( NodePtrTy const& root, IterTy begin, IterTy const& end, long long const delta )
+  {
+    CountedTrieNode* node { AllocTy::Raw( root ) };
+    for( ;; )
+    {
+      node->m_numEntries += static_cast< size_t >( delta );
+      if( begin == end )
+      {
+        return;
+      }
+      auto const& link { node->GetChild( *begin ) };
+      if( link == nullptr )
+      {
+        return;
+      }
+      node = static_cast< CountedTrieNode* >( AllocTy::Raw( link ) );
+      ++begin;
+    }
+  }
+};
@@ -15,26 +15,43 @@
 */
 
 #pragma once
+#include <iterator>
 #include "DataTrieNode.h"
-#include "BasicTrie.h"
+#include "BasicDataTrie.h"
+#include "FrozenTrie.h"
+#include "AhoCorasick.h"
 
-template< typename CharTy, typename DataTy >
-class DataTrie : public BasicTrie< DataTrieNode< CharTy, DataTy >, CharTy >
+template< typename CharTy, typename DataTy, typename AllocTy = SharedNodeAllocator, typename AlphabetTy = FullAlphabet< CharTy >,
+          typename InstrumentTy = NoTrieInstrumentation >
+class DataTrie : public BasicDataTrie< DataTrieNode< CharTy, DataTy, AllocTy, AlphabetTy, InstrumentTy >, CharTy, DataTy >
 {
 public:
-  std::shared_ptr< DataTrieNode< CharTy, DataTy > > const Insert( std::basic_string< CharTy > str )
+  // Builds a trie from a forward range of ( key, data ) pairs in a single
+  // pass, fastest when the range is sorted by key
+  template< typename IterTy >
+  static DataTrie BuildFromSorted( IterTy first, IterTy last )
   {
-    return Insert( str.begin(), str.end(), DataTy() );
+    typedef typename std::iterator_traits< IterTy >::value_type PairTy;
+
+    DataTrie trie;
+    trie.InsertSorted( first, last, []( PairTy const& pair ) -> std::basic_string< CharTy > const&
+    {
+      return pair.first;
+    }, []( DataTrieNode< CharTy, DataTy, AllocTy, AlphabetTy, InstrumentTy >& node, PairTy const& pair )
+    {
+      node.SetData( pair.second );
+    } );
+    return trie;
   }
 
-  std::shared_ptr< DataTrieNode< CharTy, DataTy > > const Insert( std::basic_string< CharTy > str, DataTy data )
+  FrozenDataTrie< CharTy, DataTy > Freeze() const
   {
-    return Insert( str.begin(), str.end(), data );
+    return FrozenDataTrie< CharTy, DataTy >( this->m_root );
   }
 
-  template< typename IterTy >
-  std::shared_ptr< DataTrieNode< CharTy, DataTy > > const Insert( IterTy&& begin, IterTy&& end, DataTy data )
+  // Multi-pattern matcher for every entry, see AhoCorasick
+  AhoCorasick< DataTrieNode< CharTy, DataTy, AllocTy, AlphabetTy, InstrumentTy >, CharTy > Compile() const
   {
-    return DataTrieNode< CharTy, DataTy >::Insert( this->m_root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ), data );
+    return AhoCorasick< DataTrieNode< CharTy, DataTy, AllocTy, AlphabetTy, InstrumentTy >, CharTy >( this->m_root );
   }
 };
@@ -17,27 +17,42 @@
 #pragma once
 #include "TrieNode.h"
 
-template< typename CharTy, typename DataTy >
-class DataTrieNode : public TrieNode< CharTy >
+template< typename CharTy, typename DataTy, typename AllocTy = SharedNodeAllocator, typename AlphabetTy = FullAlphabet< CharTy >,
+          typename InstrumentTy = NoTrieInstrumentation >
+class DataTrieNode : public TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >
 {
 public:
-  typedef std::pair < std::basic_string< CharTy >, std::shared_ptr< DataTrieNode< CharTy, DataTy > > const > Pair;
+  static constexpr size_t PayloadBytes = sizeof( DataTy );
+  typedef std::pair < std::basic_string< CharTy >, typename AllocTy::template Pointer< DataTrieNode< CharTy, DataTy, AllocTy, AlphabetTy, InstrumentTy > > const > Pair;
+
+  // Constructor tag, the data is built from the arguments which follow it
+  struct EmplaceTag
+  {
+
+  };
 
   #pragma region Constructors
-  DataTrieNode( CharTy const charVal, DataTy const data )
-    : TrieNode< CharTy >( charVal ), m_data { data }
+  DataTrieNode( CharTy const charVal, DataTy data )
+    : TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >( charVal ), m_data { std::move( data ) }
   {
     static_assert(!std::is_same< CharTy, DataTy >::value, "Cannot use same type for data as char.");
   }
 
   DataTrieNode( CharTy const charVal )
-    : DataTrieNode( charVal, DataTy() )
+    : TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >( charVal ), m_data {}
+  {
+    static_assert( !std::is_same< CharTy, DataTy >::value, "Cannot use same type for data as char." );
+  }
+
+  template< typename... ArgsTy >
+  DataTrieNode( CharTy const charVal, EmplaceTag const, ArgsTy&&... args )
+    : TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >( charVal ), m_data( std::forward< ArgsTy >( args )... )
   {
     static_assert( !std::is_same< CharTy, DataTy >::value, "Cannot use same type for data as char." );
   }
 
-  DataTrieNode( DataTy const data )
-    : DataTrieNode( static_cast< CharTy >( 0 ), data )
+  DataTrieNode( DataTy data )
+    : DataTrieNode( static_cast< CharTy >( 0 ), std::move( data ) )
   {
 
   }
@@ -54,18 +69,38 @@ public:
   {
     m_data = data;
   }
-  DataTy const GetData() const
+  void SetData( DataTy&& data )
+  {
+    m_data = std::move( data );
+  }
+  // Replaces the data with one built from args, for nodes which already
+  // exist. New nodes are built with EmplaceTag instead.
+  template< typename... ArgsTy >
+  void EmplaceData( ArgsTy&&... args )
+  {
+    m_data = DataTy( std::forward< ArgsTy >( args )... );
+  }
+  DataTy& GetData()
+  {
+    return m_data;
+  }
+  DataTy const& GetData() const
   {
     return m_data;
   }
   #pragma endregion
 
   #pragma region Static Operations
-  template< typename NodeTy, typename IterTy >
-  static std::shared_ptr < NodeTy > const Insert( std::shared_ptr< NodeTy > const& root, IterTy&& begin, IterTy&& end, DataTy data )
+  using TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >::Insert;
+
+  template< typename NodePtrTy, typename IterTy, typename DataArgTy, typename ArenaTy >
+  static NodePtrTy const Insert( NodePtrTy const& root, IterTy&& begin, IterTy&& end, DataArgTy&& data, ArenaTy& arena )
   {
-    auto& node { TrieNode< CharTy >::Insert( root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ) ) };
-    node->SetData( data );
+    auto const node { TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >::Insert( root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ), arena ) };
+    if( node != nullptr )
+    {
+      node->SetData( std::forward< DataArgTy >( data ) );
+    }
     return node;
   }
   #pragma endregion
@@ -0,0 +1,368 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+
+// Double-array transitions: a move from state s on character c goes to
+// t = base[s] + code( c ) and is valid when check[t] == s. The root is state 0.
+struct DoubleArrayUnit
+{
+  int32_t base;
+  int32_t check;
+};
+
+// Non-owning lookup over double-array storage, shared by DoubleArrayTrie and
+// the memory mapped format
+template< typename CharTy >
+class DoubleArrayView
+{
+public:
+  static_assert( sizeof( CharTy ) <= 2, "Double-array tries support 8 and 16 bit characters" );
+  static constexpr size_t NotFound = std::numeric_limits< size_t >::max();
+
+  #pragma region Constructors
+  DoubleArrayView()
+    : DoubleArrayView( nullptr, nullptr, 0ULL )
+  {
+
+  }
+
+  DoubleArrayView( DoubleArrayUnit const* const units, int32_t const* const entries, size_t const numUnits )
+    : m_units { units }, m_entries { entries }, m_numUnits { numUnits }
+  {
+
+  }
+  #pragma endregion
+
+  static size_t const Code( CharTy const c )
+  {
+    return static_cast< size_t >( static_cast< typename std::make_unsigned< CharTy >::type >( c ) ) + 1ULL;
+  }
+
+  size_t const GetChild( size_t const state, CharTy const c ) const
+  {
+    auto const next { static_cast< size_t >( m_units[state].base ) + Code( c ) };
+    if( next < m_numUnits && m_units[next].check == static_cast< int32_t >( state ) )
+    {
+      return next;
+    }
+    return NotFound;
+  }
+
+  bool const IsEndOfAnEntry( size_t const state ) const
+  {
+    return m_entries[state] >= 0;
+  }
+
+  // Index of the entry ending at state into the data array, or -1
+  int32_t const GetEntryIndex( size_t const state ) const
+  {
+    return m_entries[state];
+  }
+
+  template< typename IterTy >
+  size_t const Find( IterTy&& begin, IterTy&& end ) const
+  {
+    if( begin == end || m_numUnits == 0ULL )
+    {
+      return NotFound;
+    }
+
+    size_t state { 0ULL };
+    for( IterTy it { begin }; it != end; ++it )
+    {
+      state = GetChild( state, *it );
+      if( state == NotFound )
+      {
+        return NotFound;
+      }
+    }
+
+    return IsEndOfAnEntry( state ) ? state : NotFound;
+  }
+
+  size_t const GetNumUnits() const
+  {
+    return m_numUnits;
+  }
+
+private:
+  DoubleArrayUnit const* m_units;
+  int32_t const* m_entries;
+  size_t m_numUnits;
+};
+
+template< typename CharTy >
+class DoubleArrayTrie
+{
+public:
+  static constexpr size_t NotFound = DoubleArrayView< CharTy >::NotFound;
+
+  #pragma region Constructors
+  template< typename TrieTy >
+  explicit DoubleArrayTrie( TrieTy const& trie )
+    : DoubleArrayTrie()
+  {
+    Build( trie.GetRoot(), []( typename std::pointer_traits< typename TrieTy::NodePtr >::element_type const& ) {} );
+  }
+
+  DoubleArrayTrie( DoubleArrayTrie const& rhs )
+    : m_units { rhs.m_units }, m_entries { rhs.m_entries }, m_numEntries { rhs.m_numEntries }
+  {
+    UpdateView();
+  }
+
+  DoubleArrayTrie( DoubleArrayTrie&& rhs ) noexcept
+    : m_units { std::move( rhs.m_units ) }, m_entries { std::move( rhs.m_entries ) }, m_numEntries { rhs.m_numEntries }
+  {
+    UpdateView();
+    rhs.UpdateView();
+  }
+  #pragma endregion
+
+  #pragma region Operator Overrides
+  DoubleArrayTrie& operator=( DoubleArrayTrie rhs ) noexcept
+  {
+    m_units.swap( rhs.m_units );
+    m_entries.swap( rhs.m_entries );
+    m_numEntries = rhs.m_numEntries;
+    UpdateView();
+    return *this;
+  }
+  #pragma endregion
+
+  size_t const Find( std::basic_string< CharTy > const& str ) const
+  {
+    return m_view.Find( str.begin(), str.end() );
+  }
+
+  template< typename IterTy >
+  size_t const Find( IterTy&& begin, IterTy&& end ) const
+  {
+    return m_view.Find( std::forward< IterTy >( begin ), std::forward< IterTy >( end ) );
+  }
+
+  bool const HasString( std::basic_string< CharTy > const& str ) const
+  {
+    return Find( str ) != NotFound;
+  }
+
+  template< typename IterTy >
+  bool const HasString( IterTy&& begin, IterTy&& end ) const
+  {
+    return Find( std::forward< IterTy >( begin ), std::forward< IterTy >( end ) ) != NotFound;
+  }
+
+  DoubleArrayView< CharTy > const& GetView() const
+  {
+    return m_view;
+  }
+
+  std::vector< DoubleArrayUnit > const& GetUnits() const
+  {
+    return m_units;
+  }
+
+  std::vector< int32_t > const& GetEntries() const
+  {
+    return m_entries;
+  }
+
+  size_t const GetNumEntries() const
+  {
+    return m_numEntries;
+  }
+
+  size_t const GetSizeInBytes() const
+  {
+    return m_units.size() * sizeof( DoubleArrayUnit ) + m_entries.size() * sizeof( int32_t );
+  }
+
+protected:
+  std::vector< DoubleArrayUnit > m_units;
+  std::vector< int32_t > m_entries;
+  size_t m_numEntries;
+  DoubleArrayView< CharTy > m_view;
+
+  DoubleArrayTrie()
+    : m_numEntries { 0ULL }
+  {
+
+  }
+
+  void UpdateView()
+  {
+    m_view = DoubleArrayView< CharTy >( m_units.data(), m_entries.data(), m_units.size() );
+  }
+
+  // Places every node below root breadth first, calling onEntry( node ) for each entry
+  template< typename NodePtrTy, typename FnTy >
+  void Build( NodePtrTy const& root, FnTy&& onEntry )
+  {
+    typedef typename std::pointer_traits< NodePtrTy >::element_type NodeTy;
+    typedef typename NodeTy::Allocator AllocTy;
+
+    m_units.assign( 1ULL, DoubleArrayUnit { 0, -1 } );
+    m_entries.assign( 1ULL, -1 );
+    m_numEntries = 0ULL;
+    std::vector< uint64_t > used { 1ULL };
+
+    std::vector< std::pair< NodeTy const*, size_t > > queue;
+    if( root != nullptr )
+    {
+      queue.push_back( { AllocTy::Raw( root ), 0ULL } );
+    }
+
+    std::vector< std::pair< size_t, NodeTy const* > > children;
+    size_t firstFree { 1ULL };
+    for( size_t i { 0ULL }; i < queue.size(); ++i )
+    {
+      auto const node { queue[i].first };
+      auto const state { queue[i].second };
+      if( node->IsEndOfAnEntry() )
+      {
+        m_entries[state] = static_cast< int32_t >( m_numEntries++ );
+        onEntry( *node );
+      }
+
+      children.clear();
+      node->ForEachChild( [&children]( typename NodeTy::NodePtr const& child )
+      {
+        children.push_back( { DoubleArrayView< CharTy >::Code( child->GetChar() ), static_cast< NodeTy const* >( AllocTy::Raw( child ) ) } );
+      } );
+      if( children.empty() )
+      {
+        continue;
+      }
+
+      while( IsUsed( used, firstFree ) )
+      {
+        ++firstFree;
+      }
+
+      auto const base { FindBase( used, children, firstFree ) };
+      m_units[state].base = static_cast< int32_t >( base );
+      for( auto const& child : children )
+      {
+        auto const next { base + child.first };
+        if( next >= m_units.size() )
+        {
+          m_units.resize( next + 1ULL, DoubleArrayUnit { 0, -1 } );
+          m_entries.resize( next + 1ULL, -1 );
+        }
+        m_units[next].check = static_cast< int32_t >( state );
+        SetUsed( used, next );
+        queue.push_back( { child.second, next } );
+      }
+    }
+
+    UpdateView();
+  }
+
+private:
+  static bool const IsUsed( std::vector< uint64_t > const& used, size_t const pos )
+  {
+    auto const word { pos / 64ULL };
+    return word < used.size() && ( ( used[word] >> ( pos % 64ULL ) ) & 1ULL );
+  }
+
+  static void SetUsed( std::vector< uint64_t >& used, size_t const pos )
+  {
+    auto const word { pos / 64ULL };
+    if( word >= used.size() )
+    {
+      used.resize( word + 1ULL, 0ULL );
+    }
+    used[word] |= 1ULL << ( pos % 64ULL );
+  }
+
+  // Finds the smallest base placing every child in a free slot
+  template< typename ChildrenTy >
+  static size_t const FindBase( std::vector< uint64_t > const& used, ChildrenTy const& children, size_t const firstFree )
+  {
+    auto const firstCode { children.front().first };
+    auto pos { std::max< size_t >( firstFree, firstCode + 1ULL ) };
+    while( true )
+    {
+      // skip whole words of used slots
+      while( ( pos % 64ULL ) == 0ULL && pos / 64ULL < used.size() && used[pos / 64ULL] == ~0ULL )
+      {
+        pos += 64ULL;
+      }
+
+      if( !IsUsed( used, pos ) )
+      {
+        auto const base { pos - firstCode };
+        auto const fits { std::all_of( children.begin(), children.end(), [&used, base]( typename ChildrenTy::value_type const& child )
+        {
+          return !IsUsed( used, base + child.first );
+        } ) };
+        if( fits )
+        {
+          return base;
+        }
+      }
+      ++pos;
+    }
+  }
+};
+
+template< typename CharTy, typename DataTy >
+class DoubleArrayDataTrie : public DoubleArrayTrie< CharTy >
+{
+public:
+  #pragma region Constructors
+  template< typename TrieTy >
+  explicit DoubleArrayDataTrie( TrieTy const& trie )
+  {
+    this->Build( trie.GetRoot(), [this]( typename std::pointer_traits< typename TrieTy::NodePtr >::element_type const& node )
+    {
+      m_data.push_back( node.GetData() );
+    } );
+  }
+  #pragma endregion
+
+  DataTy const& GetData( size_t const state ) const
+  {
+    return m_data[static_cast< size_t >( this->m_view.GetEntryIndex( state ) )];
+  }
+
+  DataTy const* FindData( std::basic_string< CharTy > const& str ) const
+  {
+    auto const state { this->Find( str ) };
+    return ( state == DoubleArrayTrie< CharTy >::NotFound ) ? nullptr : &GetData( state );
+  }
+
+  std::vector< DataTy > const& GetAllData() const
+  {
+    return m_data;
+  }
+
+  size_t const GetSizeInBytes() const
+  {
+    return DoubleArrayTrie< CharTy >::GetSizeInBytes() + m_data.size() * sizeof( DataTy );
+  }
+
+private:
+  std::vector< DataTy > m_data;
+};
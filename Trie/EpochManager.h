@@ -0,0 +1,183 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Epoch based reclamation. Threads announce the global epoch in a slot while
+// they hold a Guard, and an object retired in epoch r is only deleted once
+// every announced epoch is past r, so no thread can still be reading it. At
+// most NumSlots guards can be held at once, Enter throws std::runtime_error
+// rather than wait for a slot.
+class EpochManager
+{
+public:
+  static constexpr size_t NumSlots = 256ULL;
+  static constexpr size_t CollectInterval = 64ULL;
+
+  class Guard
+  {
+  public:
+    #pragma region Constructors
+    explicit Guard( EpochManager& manager )
+      : m_slot { manager.Announce() }
+    {
+
+    }
+
+    Guard( Guard const& ) = delete;
+
+    Guard( Guard&& rhs ) noexcept
+      : m_slot { rhs.m_slot }
+    {
+      rhs.m_slot = nullptr;
+    }
+
+    ~Guard()
+    {
+      if( m_slot != nullptr )
+      {
+        m_slot->store( 0ULL, std::memory_order_release );
+      }
+    }
+    #pragma endregion
+
+    #pragma region Operator Overrides
+    Guard& operator=( Guard const& ) = delete;
+    Guard& operator=( Guard&& ) = delete;
+    #pragma endregion
+
+  private:
+    std::atomic< uint64_t >* m_slot;
+  };
+
+  #pragma region Constructors
+  EpochManager()
+    : m_epoch { 1ULL }
+  {
+    for( auto& slot : m_slots )
+    {
+      slot.epoch.store( 0ULL, std::memory_order_relaxed );
+    }
+  }
+
+  EpochManager( EpochManager const& ) = delete;
+
+  ~EpochManager()
+  {
+    for( auto const& retired : m_retired )
+    {
+      retired.deleter( retired.ptr );
+    }
+  }
+  #pragma endregion
+
+  #pragma region Operator Overrides
+  EpochManager& operator=( EpochManager const& ) = delete;
+  #pragma endregion
+
+  Guard Enter()
+  {
+    return Guard( *this );
+  }
+
+  // Deletes ptr once no thread that could have reached it holds a Guard
+  template< typename ObjTy >
+  void Retire( ObjTy* const ptr )
+  {
+    if( ptr == nullptr )
+    {
+      return;
+    }
+
+    std::lock_guard< std::mutex > lock { m_retiredMutex };
+    m_retired.push_back( { m_epoch.load(), ptr, []( void* const obj )
+    {
+      delete static_cast< ObjTy* >( obj );
+    } } );
+
+    if( m_retired.size() % CollectInterval == 0ULL )
+    {
+      Collect();
+    }
+  }
+
+private:
+  struct Slot
+  {
+    std::atomic< uint64_t > epoch;
+    char padding[64ULL - sizeof( std::atomic< uint64_t > )];
+  };
+
+  struct Retired
+  {
+    uint64_t epoch;
+    void* ptr;
+    void ( *deleter )( void* );
+  };
+
+  std::atomic< uint64_t > m_epoch;
+  Slot m_slots[NumSlots];
+  std::mutex m_retiredMutex;
+  std::vector< Retired > m_retired;
+
+  std::atomic< uint64_t >* Announce()
+  {
+    auto const epoch { m_epoch.load() };
+    auto index { std::hash< std::thread::id >()( std::this_thread::get_id() ) % NumSlots };
+    for( size_t probe { 0ULL }; probe < NumSlots; ++probe )
+    {
+      uint64_t expected { 0ULL };
+      if( m_slots[index].epoch.compare_exchange_strong( expected, epoch ) )
+      {
+        return &m_slots[index].epoch;
+      }
+      index = ( index + 1ULL ) % NumSlots;
+    }
+    throw std::runtime_error( "EpochManager: every slot is held by a Guard" );
+  }
+
+  // Called with m_retiredMutex held
+  void Collect()
+  {
+    auto oldestActive { m_epoch.fetch_add( 1ULL ) + 1ULL };
+    for( auto const& slot : m_slots )
+    {
+      auto const epoch { slot.epoch.load() };
+      if( epoch != 0ULL && epoch < oldestActive )
+      {
+        oldestActive = epoch;
+      }
+    }
+
+    auto const kept { std::partition( m_retired.begin(), m_retired.end(), [oldestActive]( Retired const& retired )
+    {
+      return retired.epoch >= oldestActive;
+    } ) };
+    for( auto it { kept }; it != m_retired.end(); ++it )
+    {
+      it->deleter( it->ptr );
+    }
+    m_retired.erase( kept, m_retired.end() );
+  }
+};
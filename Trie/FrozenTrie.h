@@ -0,0 +1,284 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <utility>
+#include "BitVector.h"
+
+// Immutable LOUDS encoding of a Trie. Nodes are numbered in level order with
+// the root as 0. The tree shape is the bit string "10" followed by 1^d 0 for
+// every node of degree d, and m_labels[n - 1] is the character into node n.
+template< typename CharTy >
+class FrozenTrie
+{
+public:
+  static constexpr size_t NotFound = std::numeric_limits< size_t >::max();
+  typedef std::pair < std::basic_string< CharTy >, size_t const > Pair;
+
+  #pragma region Constructors
+  template< typename NodePtrTy >
+  explicit FrozenTrie( NodePtrTy const& root )
+    : FrozenTrie()
+  {
+    Build( root, []( typename std::pointer_traits< NodePtrTy >::element_type const& ) {} );
+  }
+  #pragma endregion
+
+  #pragma region Node Operations
+  size_t const GetChild( size_t const node, CharTy const c ) const
+  {
+    auto const start { m_louds.Select0( node ) + 1ULL };
+    auto const end { m_louds.Select0( node + 1ULL ) };
+    auto const first { m_labels.begin() + static_cast< std::ptrdiff_t >( start - node - 2ULL ) };
+    auto const last { first + static_cast< std::ptrdiff_t >( end - start ) };
+
+    auto const index { CharIndex( c ) };
+    auto const it { std::lower_bound( first, last, c, []( CharTy const lhs, CharTy const rhs )
+    {
+      return CharIndex( lhs ) < CharIndex( rhs );
+    } ) };
+
+    if( it == last || CharIndex( *it ) != index )
+    {
+      return NotFound;
+    }
+    return static_cast< size_t >( it - m_labels.begin() ) + 1ULL;
+  }
+
+  size_t const GetNumChildren( size_t const node ) const
+  {
+    return m_louds.Select0( node + 1ULL ) - m_louds.Select0( node ) - 1ULL;
+  }
+
+  CharTy const GetChar( size_t const node ) const
+  {
+    return ( node == 0ULL ) ? static_cast< CharTy >( 0 ) : m_labels[node - 1ULL];
+  }
+
+  bool const IsEndOfAnEntry( size_t const node ) const
+  {
+    return m_entries.Get( node );
+  }
+  #pragma endregion
+
+  size_t const Find( std::basic_string< CharTy > const& str ) const
+  {
+    return Find( str.begin(), str.end() );
+  }
+
+  template< typename IterTy >
+  size_t const Find( IterTy&& begin, IterTy&& end ) const
+  {
+    if( begin == end )
+    {
+      return NotFound;
+    }
+
+    size_t node { 0ULL };
+    for( IterTy it { begin }; it != end; ++it )
+    {
+      node = GetChild( node, *it );
+      if( node == NotFound )
+      {
+        return NotFound;
+      }
+    }
+
+    return IsEndOfAnEntry( node ) ? node : NotFound;
+  }
+
+  bool const HasString( std::basic_string< CharTy > const& str ) const
+  {
+    return Find( str ) != NotFound;
+  }
+
+  template< typename IterTy >
+  bool const HasString( IterTy&& begin, IterTy&& end ) const
+  {
+    return Find( std::forward< IterTy >( begin ), std::forward< IterTy >( end ) ) != NotFound;
+  }
+
+  void GetAllStrings( std::vector< std::basic_string< CharTy > >& strings ) const
+  {
+    Enumerate( [&strings]( std::basic_string< CharTy > const& str, size_t const )
+    {
+      strings.push_back( str );
+    } );
+  }
+
+  std::vector< std::basic_string< CharTy > > const GetAllStrings() const
+  {
+    std::vector< std::basic_string< CharTy > > strings;
+    GetAllStrings( strings );
+    return strings;
+  }
+
+  void GetAllStringsWithNodes( std::vector< Pair >& stringsWithNodes ) const
+  {
+    Enumerate( [&stringsWithNodes]( std::basic_string< CharTy > const& str, size_t const node )
+    {
+      stringsWithNodes.push_back( { str, node } );
+    } );
+  }
+
+  std::vector< Pair > const GetAllStringsWithNodes() const
+  {
+    std::vector< Pair > stringsWithNodes;
+    GetAllStringsWithNodes( stringsWithNodes );
+    return stringsWithNodes;
+  }
+
+  size_t const GetNumNodes() const
+  {
+    return m_labels.size() + 1ULL;
+  }
+
+  size_t const GetNumEntries() const
+  {
+    return m_entries.NumOnes();
+  }
+
+  size_t const GetSizeInBytes() const
+  {
+    return m_louds.GetSizeInBytes() + m_entries.GetSizeInBytes() + m_labels.size() * sizeof( CharTy );
+  }
+
+protected:
+  BitVector m_louds;
+  BitVector m_entries;
+  std::vector< CharTy > m_labels;
+
+  FrozenTrie() = default;
+
+  static size_t const CharIndex( CharTy const c )
+  {
+    return static_cast< size_t >( static_cast< typename std::make_unsigned< CharTy >::type >( c ) );
+  }
+
+  // Encodes the trie below root in level order, calling onEntry( node ) for each entry
+  template< typename NodePtrTy, typename FnTy >
+  void Build( NodePtrTy const& root, FnTy&& onEntry )
+  {
+    typedef typename std::pointer_traits< NodePtrTy >::element_type NodeTy;
+    typedef typename NodeTy::Allocator AllocTy;
+
+    m_louds.PushBack( true );
+    m_louds.PushBack( false );
+
+    std::vector< NodeTy const* > queue;
+    if( root != nullptr )
+    {
+      queue.push_back( AllocTy::Raw( root ) );
+    }
+    else
+    {
+      m_entries.PushBack( false );
+      m_louds.PushBack( false );
+    }
+
+    for( size_t i { 0ULL }; i < queue.size(); ++i )
+    {
+      auto const node { queue[i] };
+      m_entries.PushBack( node->IsEndOfAnEntry() );
+      if( node->IsEndOfAnEntry() )
+      {
+        onEntry( *node );
+      }
+
+      node->ForEachChild( [this, &queue]( typename NodeTy::NodePtr const& child )
+      {
+        m_louds.PushBack( true );
+        m_labels.push_back( child->GetChar() );
+        queue.push_back( static_cast< NodeTy const* >( AllocTy::Raw( child ) ) );
+      } );
+      m_louds.PushBack( false );
+    }
+
+    m_louds.Build();
+    m_entries.Build();
+  }
+
+  // Depth first walk calling fn( key, node ) for every entry in lexicographic order
+  template< typename FnTy >
+  void Enumerate( FnTy&& fn ) const
+  {
+    std::vector< std::pair< size_t, size_t > > pending { { 0ULL, 0ULL } };
+    std::basic_string< CharTy > str;
+    while( !pending.empty() )
+    {
+      auto const node { pending.back().first };
+      auto const depth { pending.back().second };
+      pending.pop_back();
+
+      if( node != 0ULL )
+      {
+        str.resize( depth - 1ULL );
+        str.push_back( m_labels[node - 1ULL] );
+        if( IsEndOfAnEntry( node ) )
+        {
+          fn( str, node );
+        }
+      }
+
+      auto const start { m_louds.Select0( node ) + 1ULL };
+      auto const end { m_louds.Select0( node + 1ULL ) };
+      for( auto pos { end }; pos > start; --pos )
+      {
+        pending.push_back( { pos - node - 2ULL, depth + 1ULL } );
+      }
+    }
+  }
+};
+
+template< typename CharTy, typename DataTy >
+class FrozenDataTrie : public FrozenTrie< CharTy >
+{
+public:
+  #pragma region Constructors
+  template< typename NodePtrTy >
+  explicit FrozenDataTrie( NodePtrTy const& root )
+  {
+    this->Build( root, [this]( typename std::pointer_traits< NodePtrTy >::element_type const& node )
+    {
+      m_data.push_back( node.GetData() );
+    } );
+  }
+  #pragma endregion
+
+  DataTy const& GetData( size_t const node ) const
+  {
+    return m_data[this->m_entries.Rank1( node )];
+  }
+
+  DataTy const* FindData( std::basic_string< CharTy > const& str ) const
+  {
+    auto const node { this->Find( str ) };
+    return ( node == FrozenTrie< CharTy >::NotFound ) ? nullptr : &GetData( node );
+  }
+
+  size_t const GetSizeInBytes() const
+  {
+    return FrozenTrie< CharTy >::GetSizeInBytes() + m_data.size() * sizeof( DataTy );
+  }
+
+private:
+  std::vector< DataTy > m_data;
+};
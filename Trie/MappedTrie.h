@@ -0,0 +1,540 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "DoubleArrayTrie.h"
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TRIE_HAS_MMAP 1
+#endif
+
+// On-disk double-array trie. Every section is addressed by its offset from the
+// start of the file, so a mapping can be queried in place by any process.
+//
+//   TrieFileHeader
+//   DoubleArrayUnit[numUnits]   at unitsOffset
+//   int32_t[numUnits]           at entriesOffset
+//   inline:  DataTy[numEntries] at dataOffset
+//   encoded: uint64_t[numEntries + 1] value offsets at dataOffset, bytes at blobOffset
+struct TrieFileHeader
+{
+  static constexpr uint32_t CurrentVersion = 1U;
+  static constexpr uint32_t ByteOrderMark = 0x01020304U;
+
+  enum DataKind : uint32_t
+  {
+    NoData = 0U,
+    InlineData = 1U,
+    EncodedData = 2U
+  };
+
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint32_t charSize;
+  uint32_t dataKind;
+  uint64_t dataSize;
+  uint64_t numUnits;
+  uint64_t numEntries;
+  uint64_t unitsOffset;
+  uint64_t entriesOffset;
+  uint64_t dataOffset;
+  uint64_t blobOffset;
+  uint64_t fileSize;
+
+  static char const* Magic()
+  {
+    return "TRIEDAT";
+  }
+};
+
+#pragma region Codecs
+// Stores trivially copyable values directly in the file, read without copying
+template< typename DataTy >
+struct InlineTrieCodec
+{
+  static_assert( std::is_trivially_copyable< DataTy >::value, "InlineTrieCodec requires a trivially copyable type" );
+  static constexpr bool IsInline = true;
+  typedef DataTy const& ResultTy;
+};
+
+// Stores strings as their raw characters, decoded into a new string on read
+template< typename StringTy >
+struct StringTrieCodec
+{
+  static constexpr bool IsInline = false;
+  typedef StringTy ResultTy;
+
+  static void Encode( StringTy const& value, std::string& bytes )
+  {
+    bytes.append( reinterpret_cast< char const* >( value.data() ), value.size() * sizeof( typename StringTy::value_type ) );
+  }
+
+  static StringTy Decode( char const* const bytes, size_t const size )
+  {
+    StringTy value( size / sizeof( typename StringTy::value_type ), typename StringTy::value_type {} );
+    std::memcpy( &value[0], bytes, size );
+    return value;
+  }
+};
+
+template< typename DataTy, typename = void >
+struct DefaultTrieCodec
+{
+  typedef InlineTrieCodec< DataTy > Type;
+};
+
+template< typename CharTy, typename TraitsTy, typename AllocTy >
+struct DefaultTrieCodec< std::basic_string< CharTy, TraitsTy, AllocTy > >
+{
+  typedef StringTrieCodec< std::basic_string< CharTy, TraitsTy, AllocTy > > Type;
+};
+#pragma endregion
+
+// Read-only memory mapping of a whole file
+class MappedFile
+{
+public:
+  #pragma region Constructors
+  MappedFile()
+    : m_data { nullptr }, m_size { 0ULL }
+  {
+
+  }
+
+  MappedFile( MappedFile const& ) = delete;
+
+  MappedFile( MappedFile&& rhs ) noexcept
+    : m_data { rhs.m_data }, m_size { rhs.m_size }
+  {
+    rhs.m_data = nullptr;
+    rhs.m_size = 0ULL;
+  }
+
+  ~MappedFile()
+  {
+    Close();
+  }
+  #pragma endregion
+
+  #pragma region Operator Overrides
+  MappedFile& operator=( MappedFile const& ) = delete;
+
+  MappedFile& operator=( MappedFile&& rhs ) noexcept
+  {
+    if( &rhs != this )
+    {
+      Close();
+      std::swap( m_data, rhs.m_data );
+      std::swap( m_size, rhs.m_size );
+    }
+    return *this;
+  }
+  #pragma endregion
+
+  bool const Open( std::string const& path )
+  {
+    Close();
+#ifdef TRIE_HAS_MMAP
+    auto const fd { ::open( path.c_str(), O_RDONLY ) };
+    if( fd < 0 )
+    {
+      return false;
+    }
+
+    struct stat info;
+    if( ::fstat( fd, &info ) != 0 || info.st_size <= 0 )
+    {
+      ::close( fd );
+      return false;
+    }
+
+    auto const size { static_cast< size_t >( info.st_size ) };
+    auto const data { ::mmap( nullptr, size, PROT_READ, MAP_SHARED, fd, 0 ) };
+    ::close( fd );
+    if( data == MAP_FAILED )
+    {
+      return false;
+    }
+
+    m_data = static_cast< char const* >( data );
+    m_size = size;
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+  }
+
+  void Close()
+  {
+#ifdef TRIE_HAS_MMAP
+    if( m_data != nullptr )
+    {
+      ::munmap( const_cast< char* >( m_data ), m_size );
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0ULL;
+  }
+
+  char const* Data() const
+  {
+    return m_data;
+  }
+
+  size_t const Size() const
+  {
+    return m_size;
+  }
+
+private:
+  char const* m_data;
+  size_t m_size;
+};
+
+template< typename CharTy >
+class MappedTrie
+{
+public:
+  static constexpr size_t NotFound = DoubleArrayView< CharTy >::NotFound;
+
+  #pragma region Constructors
+  MappedTrie()
+    : m_header { nullptr }
+  {
+
+  }
+
+  MappedTrie( MappedTrie const& ) = delete;
+
+  // The mapping moves with the trie, the source is left closed
+  MappedTrie( MappedTrie&& rhs ) noexcept
+    : m_file { std::move( rhs.m_file ) }, m_header { rhs.m_header }, m_view { rhs.m_view }
+  {
+    rhs.m_header = nullptr;
+    rhs.m_view = DoubleArrayView< CharTy >();
+  }
+  #pragma endregion
+
+  #pragma region Operator Overrides
+  MappedTrie& operator=( MappedTrie const& ) = delete;
+
+  MappedTrie& operator=( MappedTrie&& rhs ) noexcept
+  {
+    if( &rhs != this )
+    {
+      m_file = std::move( rhs.m_file );
+      m_header = rhs.m_header;
+      m_view = rhs.m_view;
+      rhs.m_header = nullptr;
+      rhs.m_view = DoubleArrayView< CharTy >();
+    }
+    return *this;
+  }
+  #pragma endregion
+
+  // Maps the file and validates its header, leaving the trie empty on failure
+  bool const Open( std::string const& path )
+  {
+    return Open( path, TrieFileHeader::NoData, 0ULL );
+  }
+
+  void Close()
+  {
+    m_file.Close();
+    m_header = nullptr;
+    m_view = DoubleArrayView< CharTy >();
+  }
+
+  bool const IsOpen() const
+  {
+    return m_header != nullptr;
+  }
+
+  size_t const Find( std::basic_string< CharTy > const& str ) const
+  {
+    return m_view.Find( str.begin(), str.end() );
+  }
+
+  template< typename IterTy >
+  size_t const Find( IterTy&& begin, IterTy&& end ) const
+  {
+    return m_view.Find( std::forward< IterTy >( begin ), std::forward< IterTy >( end ) );
+  }
+
+  bool const HasString( std::basic_string< CharTy > const& str ) const
+  {
+    return Find( str ) != NotFound;
+  }
+
+  template< typename IterTy >
+  bool const HasString( IterTy&& begin, IterTy&& end ) const
+  {
+    return Find( std::forward< IterTy >( begin ), std::forward< IterTy >( end ) ) != NotFound;
+  }
+
+  size_t const GetNumEntries() const
+  {
+    return IsOpen() ? static_cast< size_t >( m_header->numEntries ) : 0ULL;
+  }
+
+  DoubleArrayView< CharTy > const& GetView() const
+  {
+    return m_view;
+  }
+
+protected:
+  MappedFile m_file;
+  TrieFileHeader const* m_header;
+  DoubleArrayView< CharTy > m_view;
+
+  bool const Open( std::string const& path, uint32_t const dataKind, uint64_t const dataSize )
+  {
+    Close();
+    if( !m_file.Open( path ) )
+    {
+      return false;
+    }
+
+    auto const base { m_file.Data() };
+    auto const size { static_cast< uint64_t >( m_file.Size() ) };
+    auto const header { reinterpret_cast< TrieFileHeader const* >( base ) };
+    auto const inBounds = [size]( uint64_t const offset, uint64_t const count, uint64_t const elemSize )
+    {
+      return offset <= size && count <= ( size - offset ) / elemSize;
+    };
+
+    auto const valid { size >= sizeof( TrieFileHeader )
+                    && std::memcmp( header->magic, TrieFileHeader::Magic(), sizeof( header->magic ) ) == 0
+                    && header->version == TrieFileHeader::CurrentVersion
+                    && header->byteOrder == TrieFileHeader::ByteOrderMark
+                    && header->charSize == sizeof( CharTy )
+                    && header->dataKind == dataKind
+                    && header->dataSize == dataSize
+                    && header->fileSize == size
+                    && header->numUnits > 0ULL
+                    && inBounds( header->unitsOffset, header->numUnits, sizeof( DoubleArrayUnit ) )
+                    && inBounds( header->entriesOffset, header->numUnits, sizeof( int32_t ) ) };
+    if( !valid || !ValidEntries( reinterpret_cast< int32_t const* >( base + header->entriesOffset ), header->numUnits, header->numEntries ) )
+    {
+      m_file.Close();
+      return false;
+    }
+
+    m_header = header;
+    m_view = DoubleArrayView< CharTy >( reinterpret_cast< DoubleArrayUnit const* >( base + header->unitsOffset ),
+                                        reinterpret_cast< int32_t const* >( base + header->entriesOffset ),
+                                        static_cast< size_t >( header->numUnits ) );
+    return true;
+  }
+
+private:
+  // Entry indexes read from the file are used to index the data section
+  static bool const ValidEntries( int32_t const* const entries, uint64_t const numUnits, uint64_t const numEntries )
+  {
+    for( uint64_t i { 0ULL }; i < numUnits; ++i )
+    {
+      if( entries[i] >= 0 && static_cast< uint64_t >( entries[i] ) >= numEntries )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template< typename CharTy, typename DataTy, typename CodecTy = typename DefaultTrieCodec< DataTy >::Type >
+class MappedDataTrie : public MappedTrie< CharTy >
+{
+public:
+  typedef typename CodecTy::ResultTy ResultTy;
+
+  bool const Open( std::string const& path )
+  {
+    auto const dataKind { CodecTy::IsInline ? TrieFileHeader::InlineData : TrieFileHeader::EncodedData };
+    auto const dataSize { CodecTy::IsInline ? sizeof( DataTy ) : 0ULL };
+    if( !MappedTrie< CharTy >::Open( path, dataKind, dataSize ) )
+    {
+      return false;
+    }
+
+    auto const header { this->m_header };
+    auto const size { static_cast< uint64_t >( this->m_file.Size() ) };
+    auto const valid { CodecTy::IsInline
+                     ? header->dataOffset <= size && header->numEntries <= ( size - header->dataOffset ) / sizeof( DataTy )
+                     : header->dataOffset <= size && header->numEntries < ( size - header->dataOffset ) / sizeof( uint64_t )
+                       && header->blobOffset <= size };
+    if( !valid || ( !CodecTy::IsInline && !ValidOffsets( header, size ) ) )
+    {
+      this->Close();
+      return false;
+    }
+    return true;
+  }
+
+  // A reference into the mapping for inline codecs, a decoded value otherwise
+  ResultTy GetData( size_t const state ) const
+  {
+    return GetData( static_cast< size_t >( this->m_view.GetEntryIndex( state ) ), std::integral_constant< bool, CodecTy::IsInline >() );
+  }
+
+private:
+  // Value offsets must not decrease and must stay inside the blob
+  bool const ValidOffsets( TrieFileHeader const* const header, uint64_t const size ) const
+  {
+    auto const offsets { reinterpret_cast< uint64_t const* >( this->m_file.Data() + header->dataOffset ) };
+    for( uint64_t i { 0ULL }; i < header->numEntries; ++i )
+    {
+      if( offsets[i] > offsets[i + 1ULL] )
+      {
+        return false;
+      }
+    }
+    return offsets[header->numEntries] <= size - header->blobOffset;
+  }
+
+  ResultTy GetData( size_t const entry, std::true_type ) const
+  {
+    return reinterpret_cast< DataTy const* >( this->m_file.Data() + this->m_header->dataOffset )[entry];
+  }
+
+  ResultTy GetData( size_t const entry, std::false_type ) const
+  {
+    auto const offsets { reinterpret_cast< uint64_t const* >( this->m_file.Data() + this->m_header->dataOffset ) };
+    return CodecTy::Decode( this->m_file.Data() + this->m_header->blobOffset + offsets[entry], static_cast< size_t >( offsets[entry + 1ULL] - offsets[entry] ) );
+  }
+};
+
+#pragma region Writers
+namespace TrieFile
+{
+  inline uint64_t const Align( uint64_t const offset )
+  {
+    return ( offset + 63ULL ) & ~63ULL;
+  }
+
+  template< typename CharTy >
+  inline TrieFileHeader const MakeHeader( DoubleArrayTrie< CharTy > const& trie, uint32_t const dataKind, uint64_t const dataSize )
+  {
+    TrieFileHeader header {};
+    std::memcpy( header.magic, TrieFileHeader::Magic(), sizeof( header.magic ) );
+    header.version = TrieFileHeader::CurrentVersion;
+    header.byteOrder = TrieFileHeader::ByteOrderMark;
+    header.charSize = sizeof( CharTy );
+    header.dataKind = dataKind;
+    header.dataSize = dataSize;
+    header.numUnits = trie.GetUnits().size();
+    header.numEntries = trie.GetNumEntries();
+    header.unitsOffset = Align( sizeof( TrieFileHeader ) );
+    header.entriesOffset = Align( header.unitsOffset + header.numUnits * sizeof( DoubleArrayUnit ) );
+    header.dataOffset = Align( header.entriesOffset + header.numUnits * sizeof( int32_t ) );
+    header.blobOffset = header.dataOffset;
+    header.fileSize = header.dataOffset;
+    return header;
+  }
+
+  inline void WriteAt( std::ofstream& out, uint64_t const offset, void const* const data, size_t const size )
+  {
+    static char const padding[64] {};
+    for( auto pos { static_cast< uint64_t >( out.tellp() ) }; pos < offset; pos += sizeof( padding ) )
+    {
+      out.write( padding, static_cast< std::streamsize >( std::min< uint64_t >( offset - pos, sizeof( padding ) ) ) );
+    }
+    out.write( static_cast< char const* >( data ), static_cast< std::streamsize >( size ) );
+  }
+
+  template< typename CharTy >
+  inline void WriteTrie( std::ofstream& out, TrieFileHeader const& header, DoubleArrayTrie< CharTy > const& trie )
+  {
+    WriteAt( out, 0ULL, &header, sizeof( header ) );
+    WriteAt( out, header.unitsOffset, trie.GetUnits().data(), trie.GetUnits().size() * sizeof( DoubleArrayUnit ) );
+    WriteAt( out, header.entriesOffset, trie.GetEntries().data(), trie.GetEntries().size() * sizeof( int32_t ) );
+  }
+
+  template< typename CodecTy, typename CharTy, typename DataTy >
+  inline void WriteData( std::ofstream& out, DoubleArrayDataTrie< CharTy, DataTy > const& trie, std::true_type )
+  {
+    auto const& values { trie.GetAllData() };
+    auto header { MakeHeader( trie, TrieFileHeader::InlineData, sizeof( DataTy ) ) };
+    header.fileSize = Align( header.dataOffset + values.size() * sizeof( DataTy ) );
+
+    WriteTrie( out, header, trie );
+    WriteAt( out, header.dataOffset, values.data(), values.size() * sizeof( DataTy ) );
+    WriteAt( out, header.fileSize, nullptr, 0ULL );
+  }
+
+  template< typename CodecTy, typename CharTy, typename DataTy >
+  inline void WriteData( std::ofstream& out, DoubleArrayDataTrie< CharTy, DataTy > const& trie, std::false_type )
+  {
+    std::string blob;
+    std::vector< uint64_t > offsets;
+    offsets.reserve( trie.GetAllData().size() + 1ULL );
+    for( auto const& value : trie.GetAllData() )
+    {
+      offsets.push_back( blob.size() );
+      CodecTy::Encode( value, blob );
+    }
+    offsets.push_back( blob.size() );
+
+    auto header { MakeHeader( trie, TrieFileHeader::EncodedData, 0ULL ) };
+    header.blobOffset = Align( header.dataOffset + offsets.size() * sizeof( uint64_t ) );
+    header.fileSize = Align( header.blobOffset + blob.size() );
+
+    WriteTrie( out, header, trie );
+    WriteAt( out, header.dataOffset, offsets.data(), offsets.size() * sizeof( uint64_t ) );
+    WriteAt( out, header.blobOffset, blob.data(), blob.size() );
+    WriteAt( out, header.fileSize, nullptr, 0ULL );
+  }
+}
+
+template< typename CharTy >
+bool const WriteTrieFile( std::string const& path, DoubleArrayTrie< CharTy > const& trie )
+{
+  auto const header { TrieFile::MakeHeader( trie, TrieFileHeader::NoData, 0ULL ) };
+
+  std::ofstream out { path, std::ios::binary | std::ios::trunc };
+  TrieFile::WriteTrie( out, header, trie );
+  TrieFile::WriteAt( out, header.fileSize, nullptr, 0ULL );
+  return static_cast< bool >( out );
+}
+
+template< typename CharTy, typename DataTy >
+bool const WriteTrieFile( std::string const& path, DoubleArrayDataTrie< CharTy, DataTy > const& trie )
+{
+  return WriteTrieFile< typename DefaultTrieCodec< DataTy >::Type >( path, trie );
+}
+
+template< typename CodecTy, typename CharTy, typename DataTy >
+bool const WriteTrieFile( std::string const& path, DoubleArrayDataTrie< CharTy, DataTy > const& trie )
+{
+  std::ofstream out { path, std::ios::binary | std::ios::trunc };
+  TrieFile::WriteData< CodecTy >( out, trie, std::integral_constant< bool, CodecTy::IsInline >() );
+  return static_cast< bool >( out );
+}
+#pragma endregion
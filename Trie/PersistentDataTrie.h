@@ -0,0 +1,51 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include "DataTrieNode.h"
+#include "PersistentTrie.h"
+
+template< typename CharTy, typename DataTy >
+class PersistentDataTrie : public BasicPersistentTrie< DataTrieNode< CharTy, DataTy >, CharTy >
+{
+public:
+  typedef typename BasicPersistentTrie< DataTrieNode< CharTy, DataTy >, CharTy >::NodePtr NodePtr;
+  typedef typename BasicPersistentTrie< DataTrieNode< CharTy, DataTy >, CharTy >::ConstNodePtr ConstNodePtr;
+
+  ConstNodePtr const Insert( std::basic_string< CharTy > const& str )
+  {
+    return Insert( str.begin(), str.end(), DataTy() );
+  }
+
+  ConstNodePtr const Insert( std::basic_string< CharTy > const& str, DataTy data )
+  {
+    return Insert( str.begin(), str.end(), data );
+  }
+
+  template< typename IterTy >
+  ConstNodePtr const Insert( IterTy&& begin, IterTy&& end, DataTy data )
+  {
+    return this->Update( [&]( NodePtr const& root, NodePtr& entry )
+    {
+      auto const newRoot { DataTrieNode< CharTy, DataTy >::PathCopyInsert( root, begin, end, this->m_arena, entry ) };
+      if( newRoot != nullptr )
+      {
+        entry->SetData( data );
+      }
+      return newRoot;
+    } );
+  }
+};
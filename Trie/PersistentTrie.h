@@ -0,0 +1,222 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include "TrieNode.h"
+
+// An immutable version of a persistent trie. Holding it keeps every node of
+// that version alive.
+template< typename NodeTy, typename CharTy >
+class TrieSnapshot
+{
+public:
+  typedef std::shared_ptr< NodeTy > NodePtr;
+  typedef std::shared_ptr< NodeTy const > ConstNodePtr;
+
+  #pragma region Constructors
+  explicit TrieSnapshot( NodePtr root )
+    : m_root { std::move( root ) }
+  {
+
+  }
+  #pragma endregion
+
+  ConstNodePtr const Find( std::basic_string< CharTy > const& str ) const
+  {
+    return Find( str.begin(), str.end() );
+  }
+
+  template< typename IterTy >
+  ConstNodePtr const Find( IterTy&& begin, IterTy&& end ) const
+  {
+    return NodeTy::Find( m_root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ) );
+  }
+
+  bool const HasString( std::basic_string< CharTy > const& str ) const
+  {
+    return HasString( str.begin(), str.end() );
+  }
+
+  template< typename IterTy >
+  bool const HasString( IterTy&& begin, IterTy&& end ) const
+  {
+    return NodeTy::HasString( m_root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ) );
+  }
+
+  void GetAllStrings( std::vector< std::basic_string< CharTy > >& strings ) const
+  {
+    NodeTy::GetAllStrings( m_root, strings );
+  }
+
+  std::vector< std::basic_string< CharTy > > const GetAllStrings() const
+  {
+    std::vector< std::basic_string< CharTy > > strings;
+    GetAllStrings( strings );
+    return strings;
+  }
+
+  ConstNodePtr const GetRoot() const
+  {
+    return m_root;
+  }
+
+private:
+  NodePtr m_root;
+};
+
+// Trie whose updates copy the path to the changed entry and publish a new
+// root, leaving published nodes untouched. Readers may query it or take
+// Snapshot()s from any thread without locking while writers update it.
+template< typename NodeTy, typename CharTy >
+class BasicPersistentTrie
+{
+public:
+  typedef typename NodeTy::Allocator Allocator;
+  typedef std::shared_ptr< NodeTy > NodePtr;
+  typedef std::shared_ptr< NodeTy const > ConstNodePtr;
+  typedef typename Allocator::template Arena< NodeTy > NodeArena;
+
+  #pragma region Constructors
+  BasicPersistentTrie()
+    : m_root { m_arena.Create() }
+  {
+    static_assert( std::is_base_of< TrieNode< CharTy, Allocator >, NodeTy >::value, "Must use a TrieNode type" );
+    static_assert( std::is_same< Allocator, SharedNodeAllocator >::value, "Persistent tries share nodes between versions" );
+  }
+
+  // Copies share every node with rhs
+  BasicPersistentTrie( BasicPersistentTrie const& rhs )
+    : m_root { std::atomic_load( &rhs.m_root ) }
+  {
+
+  }
+  #pragma endregion
+
+  #pragma region Operator Overrides
+  BasicPersistentTrie& operator=( BasicPersistentTrie const& rhs )
+  {
+    if( &rhs != this )
+    {
+      std::atomic_store( &m_root, std::atomic_load( &rhs.m_root ) );
+    }
+    return *this;
+  }
+  #pragma endregion
+
+  ConstNodePtr const Insert( std::basic_string< CharTy > const& str )
+  {
+    return Insert( str.begin(), str.end() );
+  }
+
+  template< typename IterTy >
+  ConstNodePtr const Insert( IterTy&& begin, IterTy&& end )
+  {
+    return Update( [&]( NodePtr const& root, NodePtr& entry )
+    {
+      return NodeTy::PathCopyInsert( root, begin, end, m_arena, entry );
+    } );
+  }
+
+  // Returns false if str was not in the trie
+  bool const Remove( std::basic_string< CharTy > const& str )
+  {
+    return Remove( str.begin(), str.end() );
+  }
+
+  template< typename IterTy >
+  bool const Remove( IterTy&& begin, IterTy&& end )
+  {
+    auto root { std::atomic_load( &m_root ) };
+    while( true )
+    {
+      auto const newRoot { NodeTy::PathCopyRemove( root, begin, end, m_arena ) };
+      if( newRoot == nullptr )
+      {
+        return false;
+      }
+      if( std::atomic_compare_exchange_strong( &m_root, &root, newRoot ) )
+      {
+        return true;
+      }
+    }
+  }
+
+  ConstNodePtr const Find( std::basic_string< CharTy > const& str ) const
+  {
+    return Snapshot().Find( str );
+  }
+
+  template< typename IterTy >
+  ConstNodePtr const Find( IterTy&& begin, IterTy&& end ) const
+  {
+    return Snapshot().Find( std::forward< IterTy >( begin ), std::forward< IterTy >( end ) );
+  }
+
+  bool const HasString( std::basic_string< CharTy > const& str ) const
+  {
+    return Snapshot().HasString( str );
+  }
+
+  template< typename IterTy >
+  bool const HasString( IterTy&& begin, IterTy&& end ) const
+  {
+    return Snapshot().HasString( std::forward< IterTy >( begin ), std::forward< IterTy >( end ) );
+  }
+
+  std::vector< std::basic_string< CharTy > > const GetAllStrings() const
+  {
+    return Snapshot().GetAllStrings();
+  }
+
+  // The current version, unaffected by later updates
+  TrieSnapshot< NodeTy, CharTy > const Snapshot() const
+  {
+    return TrieSnapshot< NodeTy, CharTy >( std::atomic_load( &m_root ) );
+  }
+
+protected:
+  NodeArena m_arena;
+  NodePtr m_root;
+
+  // Publishes update( root, entry ) unless another writer replaced the root
+  // first, in which case the update is rebuilt on top of the newer version
+  template< typename FnTy >
+  ConstNodePtr const Update( FnTy&& update )
+  {
+    NodePtr entry;
+    auto root { std::atomic_load( &m_root ) };
+    while( true )
+    {
+      auto const newRoot { update( root, entry ) };
+      if( newRoot == nullptr )
+      {
+        return nullptr;
+      }
+      if( std::atomic_compare_exchange_strong( &m_root, &root, newRoot ) )
+      {
+        return entry;
+      }
+    }
+  }
+};
+
+template< typename CharTy >
+class PersistentTrie : public BasicPersistentTrie< TrieNode< CharTy >, CharTy >
+{
+
+};
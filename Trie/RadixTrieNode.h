@@ -0,0 +1,361 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include "TrieNode.h"
+
+// Path compressed node. The edge into a node is labelled with m_label, whose
+// first character is m_char. BaseNodeTy is TrieNode or DataTrieNode.
+template< typename CharTy, typename AllocTy = SharedNodeAllocator, typename BaseNodeTy = TrieNode< CharTy, AllocTy > >
+class RadixTrieNode : public BaseNodeTy
+{
+public:
+  typedef typename TrieNode< CharTy, AllocTy >::NodePtr NodePtr;
+  typedef std::pair < std::basic_string< CharTy >, typename AllocTy::template Pointer< RadixTrieNode< CharTy, AllocTy, BaseNodeTy > > const > Pair;
+
+  template< typename NodePtrTy >
+  using NodeOf = typename TrieNode< CharTy, AllocTy >::template NodeOf< NodePtrTy >;
+
+  #pragma region Constructors
+  RadixTrieNode()
+    : BaseNodeTy()
+  {
+
+  }
+
+  // args are passed on to BaseNodeTy after the first character
+  template< typename... ArgsTy >
+  RadixTrieNode( std::basic_string< CharTy > label, ArgsTy&&... args )
+    : BaseNodeTy( label.empty() ? static_cast< CharTy >( 0 ) : label.front(), std::forward< ArgsTy >( args )... ), m_label { std::move( label ) }
+  {
+
+  }
+  #pragma endregion
+
+  std::basic_string< CharTy > const& GetLabel() const
+  {
+    return m_label;
+  }
+
+  #pragma region Static Operations
+  template< typename NodePtrTy, typename IterTy >
+  static NodePtrTy const Find( NodePtrTy const& root, IterTy&& begin, IterTy&& end )
+  {
+    typedef NodeOf< NodePtrTy > NodeTy;
+    if( root == nullptr )
+    {
+      return NodePtrTy();
+    }
+
+    NodeTy const* curNode { AllocTy::Raw( root ) };
+    NodePtr const* curLink { nullptr };
+    IterTy it { begin };
+    while( it != end )
+    {
+      curLink = &curNode->GetChild( *it );
+      if( *curLink == nullptr )
+      {
+        return NodePtrTy();
+      }
+      curNode = static_cast< NodeTy const* >( AllocTy::Raw( *curLink ) );
+
+      auto const& label { curNode->m_label };
+      auto const mismatch { std::mismatch( label.begin(), label.end(), it, end ) };
+      if( mismatch.first != label.end() )
+      {
+        return NodePtrTy();
+      }
+      it = mismatch.second;
+    }
+
+    if( curLink != nullptr && curNode->m_isEndOfAnEntry )
+    {
+      return AllocTy::template Cast< NodeTy >( *curLink );
+    }
+
+    return NodePtrTy();
+  }
+
+  template< typename IterTy >
+  static size_t const ConsumeEdge( RadixTrieNode const& node, IterTy& it, IterTy const& end )
+  {
+    auto const mismatch { std::mismatch( node.m_label.begin(), node.m_label.end(), it, end ) };
+    if( mismatch.first != node.m_label.end() )
+    {
+      return 0ULL;
+    }
+    it = mismatch.second;
+    return node.m_label.size();
+  }
+
+  // Compares the whole label with str from depth, see TrieNode::CompareEdge
+  static int const CompareEdge( RadixTrieNode const& node, std::basic_string< CharTy > const& str, size_t& depth )
+  {
+    auto const cmp { str.compare( depth, node.m_label.size(), node.m_label ) };
+    if( cmp == 0 )
+    {
+      depth += node.m_label.size();
+    }
+    return ( cmp < 0 ) ? 1 : ( cmp > 0 ) ? -1 : 0;
+  }
+
+  static void AppendEdge( RadixTrieNode const& node, std::basic_string< CharTy >& str )
+  {
+    str += node.m_label;
+  }
+
+  static size_t const GetEdgeLength( RadixTrieNode const& node )
+  {
+    return node.m_label.size();
+  }
+
+  // Labels short enough to be stored inside the string itself take no more
+  static size_t const GetEdgeBytes( RadixTrieNode const& node )
+  {
+    auto const label { reinterpret_cast< char const* >( node.m_label.data() ) };
+    auto const nodeBegin { reinterpret_cast< char const* >( &node ) };
+    std::less< char const* > const before {};
+    auto const isInline { !before( label, nodeBegin ) && before( label, nodeBegin + sizeof( RadixTrieNode ) ) };
+    return isInline ? 0ULL : ( node.m_label.capacity() + 1ULL ) * sizeof( CharTy );
+  }
+
+  template< typename NodePtrTy, typename IterTy, typename ArenaTy >
+  static NodePtrTy const Insert( NodePtrTy const& root, IterTy&& begin, IterTy&& end, ArenaTy& arena )
+  {
+    bool inserted { false };
+    return InsertEntry( root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ), arena, inserted, [&arena]( std::basic_string< CharTy > label )
+    {
+      return arena.Create( std::move( label ) );
+    } );
+  }
+
+  // Insert, creating the key's last node with createLast( label ) if it does
+  // not exist yet. inserted is set if the key was not already an entry.
+  template< typename NodePtrTy, typename IterTy, typename ArenaTy, typename CreateTy >
+  static NodePtrTy const InsertEntry( NodePtrTy const& root, IterTy&& begin, IterTy&& end, ArenaTy& arena, bool& inserted, CreateTy&& createLast )
+  {
+    typedef NodeOf< NodePtrTy > NodeTy;
+    inserted = false;
+    if( root == nullptr || begin == end )
+    {
+      return NodePtrTy();
+    }
+
+    NodeTy* curNode { AllocTy::Raw( root ) };
+    NodePtr const* curLink { nullptr };
+    IterTy it { begin };
+    while( it != end )
+    {
+      auto const& childLink { curNode->GetChild( *it ) };
+      if( childLink == nullptr )
+      {
+        auto const leaf { createLast( std::basic_string< CharTy >( it, end ) ) };
+        TrieNode< CharTy, AllocTy >::SetEndOfAnEntry( *leaf, true, arena );
+        inserted = true;
+        curNode->AddChild( leaf );
+        return AllocTy::template Cast< NodeTy >( curNode->GetChild( leaf->m_char ) );
+      }
+
+      auto const child { static_cast< NodeTy* >( AllocTy::Raw( childLink ) ) };
+      auto const mismatch { std::mismatch( child->m_label.begin(), child->m_label.end(), it, end ) };
+      it = mismatch.second;
+      if( mismatch.first != child->m_label.end() )
+      {
+        // split the edge at the first differing character, mid replaces child in place
+        auto const splitAt { static_cast< size_t >( mismatch.first - child->m_label.begin() ) };
+        auto const childPtr { AllocTy::template Cast< NodeTy >( childLink ) };
+        auto const mid { ( it == end ) ? createLast( child->m_label.substr( 0ULL, splitAt ) ) : arena.Create( child->m_label.substr( 0ULL, splitAt ) ) };
+        child->m_label.erase( 0ULL, splitAt );
+        child->m_char = child->m_label.front();
+        mid->AddChild( childPtr );
+        curNode->AddChild( mid );
+      }
+
+      curLink = &childLink;
+      curNode = static_cast< NodeTy* >( AllocTy::Raw( childLink ) );
+    }
+
+    inserted = !curNode->IsEndOfAnEntry();
+    TrieNode< CharTy, AllocTy >::SetEndOfAnEntry( *curNode, true, arena );
+    return AllocTy::template Cast< NodeTy >( *curLink );
+  }
+
+  template< typename NodePtrTy, typename IterTy, typename DataTy, typename ArenaTy >
+  static NodePtrTy const Insert( NodePtrTy const& root, IterTy&& begin, IterTy&& end, DataTy&& data, ArenaTy& arena )
+  {
+    auto const node { Insert( root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ), arena ) };
+    if( node != nullptr )
+    {
+      node->SetData( std::forward< DataTy >( data ) );
+    }
+    return node;
+  }
+
+  template< typename NodePtrTy, typename IterTy, typename ArenaTy >
+  static NodePtrTy const Remove( NodePtrTy const& root, IterTy&& begin, IterTy&& end, ArenaTy& arena )
+  {
+    typedef NodeOf< NodePtrTy > NodeTy;
+    if( root == nullptr || begin == end )
+    {
+      return NodePtrTy();
+    }
+
+    // links are the slots holding each node in its parent, nullptr for the root
+    NodeTy* grandParent { nullptr };
+    NodeTy* parent { nullptr };
+    NodeTy* curNode { AllocTy::Raw( root ) };
+    NodePtr const* grandParentLink { nullptr };
+    NodePtr const* parentLink { nullptr };
+    NodePtr const* curLink { nullptr };
+    IterTy it { begin };
+    while( it != end )
+    {
+      auto const& childLink { curNode->GetChild( *it ) };
+      if( childLink == nullptr )
+      {
+        return NodePtrTy();
+      }
+
+      grandParent = parent;
+      grandParentLink = parentLink;
+      parent = curNode;
+      parentLink = curLink;
+      curNode = static_cast< NodeTy* >( AllocTy::Raw( childLink ) );
+      curLink = &childLink;
+
+      auto const& label { curNode->m_label };
+      auto const mismatch { std::mismatch( label.begin(), label.end(), it, end ) };
+      if( mismatch.first != label.end() )
+      {
+        return NodePtrTy();
+      }
+      it = mismatch.second;
+    }
+
+    if( !curNode->m_isEndOfAnEntry )
+    {
+      return NodePtrTy();
+    }
+
+    TrieNode< CharTy, AllocTy >::SetEndOfAnEntry( *curNode, false, arena );
+    auto const numChildren { curNode->GetNumChildren() };
+    if( numChildren == 1ULL )
+    {
+      MergeWithOnlyChild( parent, curNode, arena );
+    }
+    else if( numChildren == 0ULL )
+    {
+      auto const trimmed { AllocTy::template Cast< NodeTy >( *curLink ) };
+      parent->RemoveChild( curNode->m_char );
+      TrieNode< CharTy, AllocTy >::ReleaseSubTrie( trimmed, arena );
+
+      if( grandParent != nullptr && !parent->m_isEndOfAnEntry && parent->GetNumChildren() == 1ULL )
+      {
+        MergeWithOnlyChild( grandParent, parent, arena );
+        parentLink = grandParentLink;
+      }
+    }
+
+    return ( parentLink == nullptr ) ? root : AllocTy::template Cast< NodeTy >( *parentLink );
+  }
+
+  template< typename NodePtrTy, typename IterTy >
+  static bool const HasString( NodePtrTy const& root, IterTy&& begin, IterTy&& end )
+  {
+    return Find( root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ) ) != nullptr;
+  }
+
+  template< typename NodePtrTy >
+  static void GetAllStrings( NodePtrTy const& root, std::vector< std::basic_string< CharTy > >& strings )
+  {
+    typedef NodeOf< NodePtrTy > NodeTy;
+
+    std::basic_string< CharTy > intialStr {};
+    root->m_children.ForEach( [&]( size_t const, NodePtr const& child )
+    {
+      GetAllStrings( static_cast< NodeTy const* >( AllocTy::Raw( child ) ), intialStr, strings );
+    } );
+  }
+
+  template< typename NodePtrTy >
+  static void GetAllStringsWithNodes( NodePtrTy const& root, std::vector< typename NodeOf< NodePtrTy >::Pair >& stringsWithNodes )
+  {
+    typedef NodeOf< NodePtrTy > NodeTy;
+
+    std::basic_string< CharTy > intialStr {};
+    root->m_children.ForEach( [&]( size_t const, NodePtr const& child )
+    {
+      GetAllStringsWithNodes( AllocTy::template Cast< NodeTy >( child ), intialStr, stringsWithNodes );
+    } );
+  }
+  #pragma endregion
+
+protected:
+  std::basic_string< CharTy > m_label;
+
+  #pragma region Private Static Operations
+  // Folds node into its only child, which takes its place under parent
+  template< typename NodeTy, typename ArenaTy >
+  static void MergeWithOnlyChild( NodeTy* const parent, NodeTy* const node, ArenaTy& arena )
+  {
+    auto const nodePtr { AllocTy::template Cast< NodeTy >( parent->GetChild( node->m_char ) ) };
+    typename AllocTy::template Pointer< NodeTy > childPtr {};
+    node->m_children.ForEach( [&childPtr]( size_t const, NodePtr const& child )
+    {
+      childPtr = AllocTy::template Cast< NodeTy >( child );
+    } );
+
+    childPtr->m_label.insert( 0ULL, node->m_label );
+    childPtr->m_char = node->m_char;
+    parent->AddChild( childPtr );
+    arena.Destroy( nodePtr );
+  }
+
+  template< typename NodeTy >
+  static void GetAllStrings( NodeTy const* const root, std::basic_string< CharTy > const& strToRoot, std::vector< std::basic_string< CharTy > >& strings )
+  {
+    auto const strToCurrent { strToRoot + root->m_label };
+    if( root->m_isEndOfAnEntry )
+    {
+      strings.push_back( strToCurrent );
+    }
+
+    root->m_children.ForEach( [&]( size_t const, NodePtr const& child )
+    {
+      GetAllStrings( static_cast< NodeTy const* >( AllocTy::Raw( child ) ), strToCurrent, strings );
+    } );
+  }
+
+  template< typename NodePtrTy >
+  static void GetAllStringsWithNodes( NodePtrTy const& root,
+                                      std::basic_string< CharTy > const& strToRoot,
+                                      std::vector< typename NodeOf< NodePtrTy >::Pair >& stringsWithNodes )
+  {
+    typedef NodeOf< NodePtrTy > NodeTy;
+
+    auto const strToCurrent { strToRoot + root->m_label };
+    if( root->m_isEndOfAnEntry )
+    {
+      stringsWithNodes.push_back( { strToCurrent, root } );
+    }
+
+    root->m_children.ForEach( [&]( size_t const, NodePtr const& child )
+    {
+      GetAllStringsWithNodes( AllocTy::template Cast< NodeTy >( child ), strToCurrent, stringsWithNodes );
+    } );
+  }
+  #pragma endregion
+};
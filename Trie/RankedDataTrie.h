@@ -0,0 +1,62 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include "RankedDataTrieNode.h"
+#include "BasicTrie.h"
+
+// DataTrie of scores answering "the k best completions of a prefix" without
+// enumerating the prefix's subtree. Scores are compared with operator<,
+// higher is better.
+template< typename CharTy, typename ScoreTy, typename AllocTy = SharedNodeAllocator >
+class RankedDataTrie : public BasicTrie< RankedDataTrieNode< CharTy, ScoreTy, AllocTy >, CharTy >
+{
+public:
+  typedef RankedDataTrieNode< CharTy, ScoreTy, AllocTy > NodeTy;
+  typedef typename BasicTrie< NodeTy, CharTy >::NodePtr NodePtr;
+
+  NodePtr const Insert( std::basic_string< CharTy > const& str, ScoreTy const& score )
+  {
+    return NodeTy::Insert( this->m_root, str.begin(), str.end(), score, this->m_arena );
+  }
+
+  NodePtr const Remove( std::basic_string< CharTy > const& str )
+  {
+    return NodeTy::Remove( this->m_root, str.begin(), str.end(), this->m_arena );
+  }
+
+  // Changes the score of an existing entry, returns false if str is not one
+  bool const SetData( std::basic_string< CharTy > const& str, ScoreTy const& score )
+  {
+    return NodeTy::SetScore( this->m_root, str.begin(), str.end(), score );
+  }
+
+  // The k highest scoring entries starting with prefix, best first
+  void TopKWithPrefix( std::basic_string< CharTy > const& prefix, size_t const k, std::vector< typename NodeTy::Pair >& completions ) const
+  {
+    NodeTy::TopK( this->m_root, prefix, k, [&completions]( std::basic_string< CharTy > const& key, typename NodeTy::NodePtr const& link )
+    {
+      completions.push_back( { key, NodeTy::Allocator::template Cast< NodeTy >( link ) } );
+    } );
+  }
+
+  std::vector< typename NodeTy::Pair > const TopKWithPrefix( std::basic_string< CharTy > const& prefix, size_t const k ) const
+  {
+    std::vector< typename NodeTy::Pair > completions;
+    TopKWithPrefix( prefix, k, completions );
+    return completions;
+  }
+};
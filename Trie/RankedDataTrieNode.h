@@ -0,0 +1,233 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <queue>
+#include <string>
+#include <vector>
+#include "DataTrieNode.h"
+
+// DataTrieNode whose data is a score, caching the best score in its subtree
+// so the highest scoring completions can be found best first. Every change
+// repairs the cache along the changed path, so scores can only be set
+// through the static operations here and not through SetData or GetData.
+template< typename CharTy, typename ScoreTy, typename AllocTy = SharedNodeAllocator >
+class RankedDataTrieNode : public DataTrieNode< CharTy, ScoreTy, AllocTy >
+{
+public:
+  typedef typename TrieNode< CharTy, AllocTy >::NodePtr NodePtr;
+  typedef std::pair < std::basic_string< CharTy >, typename AllocTy::template Pointer< RankedDataTrieNode< CharTy, ScoreTy, AllocTy > > const > Pair;
+
+  #pragma region Constructors
+  RankedDataTrieNode( CharTy const charVal )
+    : DataTrieNode< CharTy, ScoreTy, AllocTy >( charVal ), m_bestScore {}, m_hasBestScore { false }
+  {
+
+  }
+
+  RankedDataTrieNode()
+    : RankedDataTrieNode( static_cast< CharTy >( 0 ) )
+  {
+
+  }
+  #pragma endregion
+
+  #pragma region Getters
+  // Whether any entry is at or below this node
+  bool const HasBestScore() const
+  {
+    return m_hasBestScore;
+  }
+
+  ScoreTy const& GetData() const
+  {
+    return this->m_data;
+  }
+
+  // The highest score at or below this node
+  ScoreTy const GetBestScore() const
+  {
+    return m_bestScore;
+  }
+  #pragma endregion
+
+  #pragma region Static Operations
+  template< typename NodePtrTy, typename IterTy, typename ArenaTy >
+  static NodePtrTy const Insert( NodePtrTy const& root, IterTy begin, IterTy const& end, ScoreTy const& score, ArenaTy& arena )
+  {
+    auto const node { TrieNode< CharTy, AllocTy >::Insert( root, IterTy { begin }, IterTy { end }, arena ) };
+    if( node != nullptr )
+    {
+      node->m_data = score;
+      Repair( root, begin, end );
+    }
+    return node;
+  }
+
+  template< typename NodePtrTy, typename IterTy, typename ArenaTy >
+  static NodePtrTy const Remove( NodePtrTy const& root, IterTy begin, IterTy const& end, ArenaTy& arena )
+  {
+    auto const node { TrieNode< CharTy, AllocTy >::Remove( root, IterTy { begin }, IterTy { end }, arena ) };
+    if( node != nullptr )
+    {
+      Repair( root, begin, end );
+    }
+    return node;
+  }
+
+  // Returns false if [begin, end) is not an entry
+  template< typename NodePtrTy, typename IterTy >
+  static bool const SetScore( NodePtrTy const& root, IterTy begin, IterTy const& end, ScoreTy const& score )
+  {
+    auto const node { TrieNode< CharTy, AllocTy >::Find( root, IterTy { begin }, IterTy { end } ) };
+    if( node == nullptr )
+    {
+      return false;
+    }
+    node->m_data = score;
+    Repair( root, begin, end );
+    return true;
+  }
+
+  // Calls fn( key, link ) for the k highest scoring entries starting with
+  // prefix, best first and ties in key order. Subtrees are expanded in
+  // order of their cached best score, so only the subtrees holding the
+  // results and their siblings are touched.
+  template< typename NodePtrTy, typename FnTy >
+  static void TopK( NodePtrTy const& root, std::basic_string< CharTy > const& prefix, size_t k, FnTy&& fn )
+  {
+    if( root == nullptr || k == 0ULL )
+    {
+      return;
+    }
+
+    RankedDataTrieNode const* node { AllocTy::Raw( root ) };
+    NodePtr const* link { nullptr };
+    for( auto const c : prefix )
+    {
+      link = &node->GetChild( c );
+      if( *link == nullptr )
+      {
+        return;
+      }
+      node = static_cast< RankedDataTrieNode const* >( AllocTy::Raw( *link ) );
+    }
+
+    // a subtree candidate ranks by its best score and, as every key below
+    // it is at least its own, by its key
+    struct Candidate
+    {
+      ScoreTy score;
+      std::basic_string< CharTy > key;
+      RankedDataTrieNode const* node;
+      NodePtr const* link;
+      bool isEntry;
+    };
+    auto const ranksBelow = []( Candidate const& lhs, Candidate const& rhs )
+    {
+      if( lhs.score < rhs.score || rhs.score < lhs.score )
+      {
+        return lhs.score < rhs.score;
+      }
+      return ( lhs.key != rhs.key ) ? rhs.key < lhs.key : rhs.isEntry && !lhs.isEntry;
+    };
+    std::priority_queue< Candidate, std::vector< Candidate >, decltype( ranksBelow ) > candidates { ranksBelow };
+
+    if( node->m_hasBestScore )
+    {
+      candidates.push( { node->m_bestScore, prefix, node, link, false } );
+    }
+    while( !candidates.empty() && k > 0ULL )
+    {
+      auto const top { candidates.top() };
+      candidates.pop();
+      if( top.isEntry )
+      {
+        fn( top.key, *top.link );
+        --k;
+        continue;
+      }
+
+      if( top.node->m_isEndOfAnEntry && top.link != nullptr )
+      {
+        candidates.push( { top.node->m_data, top.key, top.node, top.link, true } );
+      }
+      top.node->ForEachChild( [&candidates, &top]( NodePtr const& child )
+      {
+        auto const childNode { static_cast< RankedDataTrieNode const* >( AllocTy::Raw( child ) ) };
+        if( childNode->m_hasBestScore )
+        {
+          candidates.push( { childNode->m_bestScore, top.key + childNode->m_char, childNode, &child, false } );
+        }
+      } );
+    }
+  }
+  #pragma endregion
+
+private:
+  using DataTrieNode< CharTy, ScoreTy, AllocTy >::SetData;
+  using DataTrieNode< CharTy, ScoreTy, AllocTy >::EmplaceData;
+
+  ScoreTy m_bestScore;
+  bool m_hasBestScore;
+
+  // Recomputes the cached best score from this node's entry and children,
+  // returns whether it changed
+  bool const UpdateBestScore()
+  {
+    auto const hadBestScore { m_hasBestScore };
+    auto const bestScore { m_bestScore };
+
+    m_hasBestScore = this->m_isEndOfAnEntry;
+    if( m_hasBestScore )
+    {
+      m_bestScore = this->m_data;
+    }
+    this->ForEachChild( [this]( NodePtr const& child )
+    {
+      auto const childNode { static_cast< RankedDataTrieNode const* >( AllocTy::Raw( child ) ) };
+      if( childNode->m_hasBestScore && ( !m_hasBestScore || m_bestScore < childNode->m_bestScore ) )
+      {
+        m_bestScore = childNode->m_bestScore;
+        m_hasBestScore = true;
+      }
+    } );
+
+    return m_hasBestScore != hadBestScore || ( m_hasBestScore && ( bestScore < m_bestScore || m_bestScore < bestScore ) );
+  }
+
+  // Updates the cache bottom up along the path to [begin, end), stopping at
+  // the first node whose best score did not change
+  template< typename NodePtrTy, typename IterTy >
+  static void Repair( NodePtrTy const& root, IterTy begin, IterTy const& end )
+  {
+    std::vector< RankedDataTrieNode* > path { AllocTy::Raw( root ) };
+    for( ; begin != end; ++begin )
+    {
+      auto const& link { path.back()->GetChild( *begin ) };
+      if( link == nullptr )
+      {
+        break;
+      }
+      path.push_back( static_cast< RankedDataTrieNode* >( AllocTy::Raw( link ) ) );
+    }
+
+    for( auto i { path.size() }; i > 0ULL && path[i - 1ULL]->UpdateBestScore(); --i )
+    {
+
+    }
+  }
+};
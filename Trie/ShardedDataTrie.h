@@ -0,0 +1,247 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <queue>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+#include "DataTrie.h"
+
+// DataTrie split into NumShards independent shards by a hash of the first
+// character. Each shard has its own reader-writer lock so operations on
+// different shards never contend.
+template< typename CharTy, typename DataTy, size_t NumShards = 16ULL >
+class ShardedDataTrie
+{
+public:
+  static_assert( NumShards > 0ULL, "Must use at least one shard" );
+  typedef DataTrie< CharTy, DataTy > ShardTy;
+  typedef std::pair< std::basic_string< CharTy >, DataTy > Pair;
+
+  #pragma region Constructors
+  ShardedDataTrie() = default;
+  ShardedDataTrie( ShardedDataTrie const& ) = delete;
+  #pragma endregion
+
+  #pragma region Operator Overrides
+  ShardedDataTrie& operator=( ShardedDataTrie const& ) = delete;
+  #pragma endregion
+
+  bool const Insert( std::basic_string< CharTy > const& str, DataTy data )
+  {
+    auto& shard { GetShard( str ) };
+    std::lock_guard< std::shared_timed_mutex > lock { shard.mutex };
+    return shard.trie.Insert( str, std::move( data ) ) != nullptr;
+  }
+
+  // Returns false if str was not in the trie
+  bool const Remove( std::basic_string< CharTy > const& str )
+  {
+    auto& shard { GetShard( str ) };
+    std::lock_guard< std::shared_timed_mutex > lock { shard.mutex };
+    return shard.trie.Remove( str ) != nullptr;
+  }
+
+  bool const HasString( std::basic_string< CharTy > const& str ) const
+  {
+    auto const& shard { GetShard( str ) };
+    std::shared_lock< std::shared_timed_mutex > lock { shard.mutex };
+    return shard.trie.HasString( str );
+  }
+
+  // Copies the data of str into data, returns false if str is not in the trie
+  bool const FindData( std::basic_string< CharTy > const& str, DataTy& data ) const
+  {
+    auto const& shard { GetShard( str ) };
+    std::shared_lock< std::shared_timed_mutex > lock { shard.mutex };
+    auto const node { shard.trie.Find( str ) };
+    if( node == nullptr )
+    {
+      return false;
+    }
+    data = node->GetData();
+    return true;
+  }
+
+  // Inserts every ( key, data ) pair in [begin, end), filling shards in
+  // parallel. The data is copied, or moved if the iterators yield rvalues
+  // such as std::move_iterator does.
+  template< typename IterTy >
+  void BulkInsert( IterTy begin, IterTy end, size_t numThreads = std::thread::hardware_concurrency() )
+  {
+    typedef typename std::iterator_traits< IterTy >::reference ReferenceTy;
+    std::vector< std::vector< IterTy > > groups( NumShards );
+    for( auto it { begin }; it != end; ++it )
+    {
+      groups[ShardIndex( it->first )].push_back( it );
+    }
+
+    std::atomic< size_t > nextShard { 0ULL };
+    auto const fillShards = [this, &groups, &nextShard]()
+    {
+      for( auto i { nextShard++ }; i < NumShards; i = nextShard++ )
+      {
+        std::lock_guard< std::shared_timed_mutex > lock { m_shards[i].mutex };
+        for( auto const& it : groups[i] )
+        {
+          m_shards[i].trie.Insert( it->first, std::forward< ReferenceTy >( *it ).second );
+        }
+      }
+    };
+
+    numThreads = std::min( std::max< size_t >( numThreads, 1ULL ), NumShards );
+    std::vector< std::thread > workers;
+    for( size_t i { 1ULL }; i < numThreads; ++i )
+    {
+      workers.emplace_back( fillShards );
+    }
+    fillShards();
+    for( auto& worker : workers )
+    {
+      worker.join();
+    }
+  }
+
+  // Copies the data out of range
+  template< typename RangeTy >
+  void BulkInsert( RangeTy const& range, size_t const numThreads = std::thread::hardware_concurrency() )
+  {
+    BulkInsert( std::begin( range ), std::end( range ), numThreads );
+  }
+
+  // Every entry in lexicographic order, merged across shards
+  void GetAllStrings( std::vector< std::basic_string< CharTy > >& strings ) const
+  {
+    strings = Merge< std::basic_string< CharTy > >( []( ShardTy const& trie, std::vector< std::basic_string< CharTy > >& shardStrings )
+    {
+      trie.GetAllStrings( shardStrings );
+    } );
+  }
+
+  std::vector< std::basic_string< CharTy > > const GetAllStrings() const
+  {
+    std::vector< std::basic_string< CharTy > > strings;
+    GetAllStrings( strings );
+    return strings;
+  }
+
+  void GetAllStringsWithData( std::vector< Pair >& stringsWithData ) const
+  {
+    stringsWithData = Merge< Pair >( []( ShardTy const& trie, std::vector< Pair >& shardStringsWithData )
+    {
+      for( auto const& pair : trie.GetAllStringsWithNodes() )
+      {
+        shardStringsWithData.push_back( { pair.first, pair.second->GetData() } );
+      }
+    } );
+  }
+
+  std::vector< Pair > const GetAllStringsWithData() const
+  {
+    std::vector< Pair > stringsWithData;
+    GetAllStringsWithData( stringsWithData );
+    return stringsWithData;
+  }
+
+  static size_t const ShardIndex( std::basic_string< CharTy > const& str )
+  {
+    if( str.empty() )
+    {
+      return 0ULL;
+    }
+    auto const c { static_cast< uint64_t >( static_cast< typename std::make_unsigned< CharTy >::type >( str.front() ) ) };
+    return static_cast< size_t >( ( ( c + 1ULL ) * 0x9E3779B97F4A7C15ULL ) >> 32 ) % NumShards;
+  }
+
+private:
+  struct Shard
+  {
+    mutable std::shared_timed_mutex mutex;
+    ShardTy trie;
+  };
+
+  Shard m_shards[NumShards];
+
+  Shard& GetShard( std::basic_string< CharTy > const& str )
+  {
+    return m_shards[ShardIndex( str )];
+  }
+
+  Shard const& GetShard( std::basic_string< CharTy > const& str ) const
+  {
+    return m_shards[ShardIndex( str )];
+  }
+
+  static std::basic_string< CharTy > const& KeyOf( std::basic_string< CharTy > const& str )
+  {
+    return str;
+  }
+
+  static std::basic_string< CharTy > const& KeyOf( Pair const& pair )
+  {
+    return pair.first;
+  }
+
+  // Runs collect( trie, entries ) on each shard under its lock, then merges
+  // the sorted per-shard entries into one lexicographically ordered list
+  template< typename EntryTy, typename CollectFnTy >
+  std::vector< EntryTy > Merge( CollectFnTy&& collect ) const
+  {
+    std::vector< std::vector< EntryTy > > shardEntries( NumShards );
+    size_t numEntries { 0ULL };
+    for( size_t i { 0ULL }; i < NumShards; ++i )
+    {
+      std::shared_lock< std::shared_timed_mutex > lock { m_shards[i].mutex };
+      collect( m_shards[i].trie, shardEntries[i] );
+      numEntries += shardEntries[i].size();
+    }
+
+    // min-heap of ( shard, position ) ordered by the key at that position
+    typedef std::pair< size_t, size_t > Cursor;
+    auto const greater = [&shardEntries]( Cursor const& lhs, Cursor const& rhs )
+    {
+      return KeyOf( shardEntries[rhs.first][rhs.second] ) < KeyOf( shardEntries[lhs.first][lhs.second] );
+    };
+    std::priority_queue< Cursor, std::vector< Cursor >, decltype( greater ) > heads { greater };
+    for( size_t i { 0ULL }; i < NumShards; ++i )
+    {
+      if( !shardEntries[i].empty() )
+      {
+        heads.push( { i, 0ULL } );
+      }
+    }
+
+    std::vector< EntryTy > entries;
+    entries.reserve( numEntries );
+    while( !heads.empty() )
+    {
+      auto const head { heads.top() };
+      heads.pop();
+      entries.push_back( std::move( shardEntries[head.first][head.second] ) );
+      if( head.second + 1ULL < shardEntries[head.first].size() )
+      {
+        heads.push( { head.first, head.second + 1ULL } );
+      }
+    }
+    return entries;
+  }
+};
@@ -0,0 +1,245 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// Trie over a fixed list of keywords built at compile time into static
+// tables, with no allocation and nothing to do at startup. Entries are
+// reported by their position in the list given to MakeStaticTrie. Nodes are
+// numbered with the root as 0, each links its first child and next sibling,
+// and siblings are sorted so a search stops at the first larger character.
+// Index 0 is never a child or sibling, so it also marks a missing link.
+template< typename CharTy, size_t MaxNodes >
+class StaticTrie
+{
+public:
+  static constexpr size_t NoEntry = std::numeric_limits< size_t >::max();
+
+  #pragma region Constructors
+  // keys[i] is the ith keyword, lengths[i] its length
+  constexpr StaticTrie( CharTy const* const* const keys, size_t const* const lengths, size_t const numKeys )
+    : m_chars {}, m_firstChild {}, m_nextSibling {}, m_entries {}, m_rootChildren {}, m_numNodes { 1ULL }, m_numEntries { 0ULL }
+  {
+    for( size_t i { 0ULL }; i < numKeys; ++i )
+    {
+      Insert( keys[i], lengths[i], i );
+    }
+  }
+  #pragma endregion
+
+  #pragma region Getters
+  constexpr size_t const GetNumNodes() const
+  {
+    return m_numNodes;
+  }
+
+  // Keywords listed more than once are counted once
+  constexpr size_t const GetNumEntries() const
+  {
+    return m_numEntries;
+  }
+  #pragma endregion
+
+  // The position of str in the keyword list, or NoEntry. A keyword listed
+  // more than once reports its first position.
+  size_t const Find( std::basic_string< CharTy > const& str ) const
+  {
+    return Find( str.data(), str.data() + str.size() );
+  }
+
+  constexpr size_t const Find( CharTy const* const str ) const
+  {
+    return Find( str, str + Length( str ) );
+  }
+
+  template< typename IterTy >
+  constexpr size_t const Find( IterTy begin, IterTy const& end ) const
+  {
+    size_t node { 0ULL };
+    for( ; begin != end; ++begin )
+    {
+      node = GetChild( node, *begin );
+      if( node == 0ULL )
+      {
+        return NoEntry;
+      }
+    }
+    return EntryOf( node );
+  }
+
+  bool const HasString( std::basic_string< CharTy > const& str ) const
+  {
+    return Find( str ) != NoEntry;
+  }
+
+  constexpr bool const HasString( CharTy const* const str ) const
+  {
+    return Find( str ) != NoEntry;
+  }
+
+  template< typename IterTy >
+  constexpr bool const HasString( IterTy begin, IterTy const& end ) const
+  {
+    return Find( begin, end ) != NoEntry;
+  }
+
+  // The longest keyword which is a prefix of str, as its length and
+  // position, or ( 0, NoEntry ) if there is none
+  std::pair< size_t, size_t > const LongestPrefixOf( std::basic_string< CharTy > const& str ) const
+  {
+    return LongestPrefixOf( str.data(), str.data() + str.size() );
+  }
+
+  constexpr std::pair< size_t, size_t > const LongestPrefixOf( CharTy const* const str ) const
+  {
+    return LongestPrefixOf( str, str + Length( str ) );
+  }
+
+  template< typename IterTy >
+  constexpr std::pair< size_t, size_t > const LongestPrefixOf( IterTy begin, IterTy const& end ) const
+  {
+    size_t longest { 0ULL };
+    size_t longestNode { 0ULL };
+    size_t node { 0ULL };
+    for( size_t length { 1ULL }; begin != end; ++begin, ++length )
+    {
+      node = GetChild( node, *begin );
+      if( node == 0ULL )
+      {
+        break;
+      }
+      if( m_entries[node] != 0U )
+      {
+        longest = length;
+        longestNode = node;
+      }
+    }
+    return { longest, EntryOf( longestNode ) };
+  }
+
+  static constexpr size_t const CharIndex( CharTy const c )
+  {
+    return static_cast< size_t >( static_cast< typename std::make_unsigned< CharTy >::type >( c ) );
+  }
+
+private:
+  typedef typename std::conditional< ( MaxNodes < ( 1ULL << 16 ) ), uint16_t, uint32_t >::type IndexTy;
+  static constexpr bool HasRootTable = sizeof( CharTy ) == 1ULL;
+
+  CharTy m_chars[MaxNodes];
+  IndexTy m_firstChild[MaxNodes];
+  IndexTy m_nextSibling[MaxNodes];
+  // one past the keyword's position, 0 if no keyword ends here
+  IndexTy m_entries[MaxNodes];
+  IndexTy m_rootChildren[HasRootTable ? ( 1ULL << 8 ) : 1ULL];
+  size_t m_numNodes;
+  size_t m_numEntries;
+
+  static constexpr size_t const Length( CharTy const* const str )
+  {
+    size_t length { 0ULL };
+    while( str[length] != static_cast< CharTy >( 0 ) )
+    {
+      ++length;
+    }
+    return length;
+  }
+
+  constexpr size_t const EntryOf( size_t const node ) const
+  {
+    return ( m_entries[node] == 0U ) ? NoEntry : m_entries[node] - 1ULL;
+  }
+
+  // The child of node on c, or 0
+  constexpr size_t const GetChild( size_t const node, CharTy const c ) const
+  {
+    auto const index { CharIndex( c ) };
+    if( HasRootTable && node == 0ULL )
+    {
+      return m_rootChildren[index];
+    }
+    size_t child { m_firstChild[node] };
+    while( child != 0ULL && CharIndex( m_chars[child] ) < index )
+    {
+      child = m_nextSibling[child];
+    }
+    return ( child != 0ULL && CharIndex( m_chars[child] ) == index ) ? child : 0ULL;
+  }
+
+  constexpr void Insert( CharTy const* const key, size_t const length, size_t const position )
+  {
+    size_t node { 0ULL };
+    for( size_t i { 0ULL }; i < length; ++i )
+    {
+      auto const index { CharIndex( key[i] ) };
+
+      // the link which the child on key[i] is, or would be, stored in
+      IndexTy* link { &m_firstChild[node] };
+      while( *link != 0U && CharIndex( m_chars[*link] ) < index )
+      {
+        link = &m_nextSibling[*link];
+      }
+      if( *link == 0U || CharIndex( m_chars[*link] ) != index )
+      {
+        m_chars[m_numNodes] = key[i];
+        m_nextSibling[m_numNodes] = *link;
+        *link = static_cast< IndexTy >( m_numNodes );
+        if( HasRootTable && node == 0ULL )
+        {
+          m_rootChildren[index] = static_cast< IndexTy >( m_numNodes );
+        }
+        ++m_numNodes;
+      }
+      node = *link;
+    }
+
+    if( m_entries[node] == 0U )
+    {
+      m_entries[node] = static_cast< IndexTy >( position + 1ULL );
+      ++m_numEntries;
+    }
+  }
+};
+
+template< typename CharTy, size_t MaxNodes >
+constexpr size_t StaticTrie< CharTy, MaxNodes >::NoEntry;
+
+// Upper bound on the nodes of a StaticTrie over keywords of these lengths
+constexpr size_t StaticTrieMaxNodes( std::initializer_list< size_t > const lengths )
+{
+  size_t numNodes { 1ULL };
+  for( auto const length : lengths )
+  {
+    numNodes += length;
+  }
+  return numNodes;
+}
+
+// Builds a StaticTrie from string literals, usable in a constant expression:
+//   constexpr auto methods { MakeStaticTrie( "GET", "HEAD", "POST" ) };
+template< typename CharTy, size_t... Ns >
+constexpr StaticTrie< CharTy, StaticTrieMaxNodes( { ( Ns - 1ULL )... } ) > MakeStaticTrie( CharTy const ( &... keys )[Ns] )
+{
+  CharTy const* const keyList[sizeof...( Ns ) + 1ULL] { keys..., nullptr };
+  size_t const lengths[sizeof...( Ns ) + 1ULL] { ( Ns - 1ULL )..., 0ULL };
+  return StaticTrie< CharTy, StaticTrieMaxNodes( { ( Ns - 1ULL )... } ) >( keyList, lengths, sizeof...( Ns ) );
+}
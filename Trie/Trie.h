@@ -17,9 +17,35 @@
 #pragma once
 #include "TrieNode.h"
 #include "BasicTrie.h"
+#include "FrozenTrie.h"
+#include "AhoCorasick.h"
 
-template< typename CharTy >
-class Trie : public BasicTrie< TrieNode< CharTy >, CharTy >
+template< typename CharTy, typename AllocTy = SharedNodeAllocator, typename AlphabetTy = FullAlphabet< CharTy >,
+          typename InstrumentTy = NoTrieInstrumentation >
+class Trie : public BasicTrie< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >, CharTy >
 {
+public:
+  // Builds a trie from a forward range of strings in a single pass, fastest
+  // when the range is sorted
+  template< typename IterTy >
+  static Trie BuildFromSorted( IterTy first, IterTy last )
+  {
+    Trie trie;
+    trie.InsertSorted( first, last, []( std::basic_string< CharTy > const& key ) -> std::basic_string< CharTy > const&
+    {
+      return key;
+    }, []( TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy > const&, std::basic_string< CharTy > const& ) {} );
+    return trie;
+  }
 
+  FrozenTrie< CharTy > Freeze() const
+  {
+    return FrozenTrie< CharTy >( this->m_root );
+  }
+
+  // Multi-pattern matcher for every entry, see AhoCorasick
+  AhoCorasick< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >, CharTy > Compile() const
+  {
+    return AhoCorasick< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >, CharTy >( this->m_root );
+  }
 };
\ No newline at end of file
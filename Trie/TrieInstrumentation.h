@@ -0,0 +1,255 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Instrumentation policies for TrieNode's Find, Insert and Remove. Each
+// operation creates a Scope, reports every node it visits and every node it
+// allocates, marks itself a hit if it succeeds, and is recorded when the
+// Scope is destroyed. A hit is a Find which found the key, an Insert which
+// added a new entry, or a Remove which removed one.
+
+enum class TrieOperation : uint8_t
+{
+  Find,
+  Insert,
+  Remove
+};
+
+static constexpr size_t NumTrieOperations = 3ULL;
+static constexpr size_t NumTrieLatencyBuckets = 32ULL;
+
+// Counts for one kind of operation
+struct TrieOperationStats
+{
+  size_t numOps;
+  size_t numHits;
+  size_t numNodesVisited;
+  size_t numAllocations;
+  // latency[i] is the number of operations taking [2^i, 2^(i+1)) ns, the
+  // first and last buckets also count anything faster or slower
+  size_t latency[NumTrieLatencyBuckets];
+
+  double const GetHitRatio() const
+  {
+    return ( numOps == 0ULL ) ? 0.0 : static_cast< double >( numHits ) / static_cast< double >( numOps );
+  }
+
+  double const GetAverageNodesVisited() const
+  {
+    return ( numOps == 0ULL ) ? 0.0 : static_cast< double >( numNodesVisited ) / static_cast< double >( numOps );
+  }
+};
+
+// Default policy, every hook is empty and compiles away
+struct NoTrieInstrumentation
+{
+  class Scope
+  {
+  public:
+    explicit Scope( TrieOperation const )
+    {
+
+    }
+
+    void Visit()
+    {
+
+    }
+
+    void Allocate()
+    {
+
+    }
+
+    void Hit()
+    {
+
+    }
+  };
+};
+
+// Records into counters owned by the calling thread, so threads never write
+// to the same counters. Collect sums every thread's counters, including
+// threads which have exited. Counters are shared by all tries using the
+// policy. Timing each operation costs two clock reads, set RecordLatency to
+// false to leave the latency histogram empty instead.
+template< bool RecordLatency = true >
+class TrieInstrumentation
+{
+  class ThreadCounters;
+
+public:
+  static constexpr bool RecordsLatency = RecordLatency;
+
+  class Scope
+  {
+  public:
+    explicit Scope( TrieOperation const operation )
+      : m_operation { operation }, m_numNodesVisited { 0ULL }, m_numAllocations { 0ULL }, m_hit { false },
+        m_start { RecordLatency ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point() }
+    {
+
+    }
+
+    Scope( Scope const& ) = delete;
+    Scope& operator=( Scope const& ) = delete;
+
+    ~Scope()
+    {
+      auto& counters { ThreadCounters::Local().m_counters[static_cast< size_t >( m_operation )] };
+      Add( counters.numOps, 1ULL );
+      Add( counters.numHits, m_hit ? 1ULL : 0ULL );
+      Add( counters.numNodesVisited, m_numNodesVisited );
+      Add( counters.numAllocations, m_numAllocations );
+      if( RecordLatency )
+      {
+        auto const ns { std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - m_start ).count() };
+        Add( counters.latency[LatencyBucket( static_cast< uint64_t >( std::max< int64_t >( ns, 0 ) ) )], 1ULL );
+      }
+    }
+
+    void Visit()
+    {
+      ++m_numNodesVisited;
+    }
+
+    void Allocate()
+    {
+      ++m_numAllocations;
+    }
+
+    void Hit()
+    {
+      m_hit = true;
+    }
+
+  private:
+    TrieOperation m_operation;
+    size_t m_numNodesVisited;
+    size_t m_numAllocations;
+    bool m_hit;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+  static TrieOperationStats const Collect( TrieOperation const operation )
+  {
+    auto& registry { GetRegistry() };
+    std::lock_guard< std::mutex > lock { registry.mutex };
+    auto stats { registry.retired[static_cast< size_t >( operation )] };
+    for( auto const threadCounters : registry.threads )
+    {
+      AddTo( stats, threadCounters->m_counters[static_cast< size_t >( operation )] );
+    }
+    return stats;
+  }
+
+  static size_t const LatencyBucket( uint64_t ns )
+  {
+    size_t bucket { 0ULL };
+    while( ns > 1ULL && bucket + 1ULL < NumTrieLatencyBuckets )
+    {
+      ns >>= 1;
+      ++bucket;
+    }
+    return bucket;
+  }
+
+private:
+  struct Counters
+  {
+    std::atomic< size_t > numOps;
+    std::atomic< size_t > numHits;
+    std::atomic< size_t > numNodesVisited;
+    std::atomic< size_t > numAllocations;
+    std::atomic< size_t > latency[NumTrieLatencyBuckets];
+  };
+
+  struct Registry
+  {
+    std::mutex mutex;
+    std::vector< ThreadCounters* > threads;
+    TrieOperationStats retired[NumTrieOperations];
+  };
+
+  class ThreadCounters
+  {
+  public:
+    Counters m_counters[NumTrieOperations];
+
+    ThreadCounters()
+      : m_counters {}
+    {
+      auto& registry { GetRegistry() };
+      std::lock_guard< std::mutex > lock { registry.mutex };
+      registry.threads.push_back( this );
+    }
+
+    // Folds this thread's counts into the retired totals
+    ~ThreadCounters()
+    {
+      auto& registry { GetRegistry() };
+      std::lock_guard< std::mutex > lock { registry.mutex };
+      for( size_t i { 0ULL }; i < NumTrieOperations; ++i )
+      {
+        AddTo( registry.retired[i], m_counters[i] );
+      }
+      registry.threads.erase( std::find( registry.threads.begin(), registry.threads.end(), this ) );
+    }
+
+    static ThreadCounters& Local()
+    {
+      thread_local ThreadCounters counters;
+      return counters;
+    }
+  };
+
+  // Only the owning thread writes its counters, so a relaxed load and store
+  // is enough and avoids a locked read-modify-write
+  static void Add( std::atomic< size_t >& counter, size_t const value )
+  {
+    counter.store( counter.load( std::memory_order_relaxed ) + value, std::memory_order_relaxed );
+  }
+
+  static void AddTo( TrieOperationStats& stats, Counters const& counters )
+  {
+    stats.numOps += counters.numOps.load( std::memory_order_relaxed );
+    stats.numHits += counters.numHits.load( std::memory_order_relaxed );
+    stats.numNodesVisited += counters.numNodesVisited.load( std::memory_order_relaxed );
+    stats.numAllocations += counters.numAllocations.load( std::memory_order_relaxed );
+    for( size_t i { 0ULL }; i < NumTrieLatencyBuckets; ++i )
+    {
+      stats.latency[i] += counters.latency[i].load( std::memory_order_relaxed );
+    }
+  }
+
+  // Never destroyed, so threads exiting during static destruction can still
+  // fold their counts into it
+  static Registry& GetRegistry()
+  {
+    static Registry* const registry { new Registry {} };
+    return *registry;
+  }
+};
+
+template< bool RecordLatency >
+constexpr bool TrieInstrumentation< RecordLatency >::RecordsLatency;
@@ -0,0 +1,235 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "TrieNode.h"
+
+// Iterator over the entries of a trie in lexicographic order. It holds the
+// path from the root to the current entry, so creating one costs O( depth )
+// and each step only visits the nodes between two entries. Dereferencing
+// yields a ( key, node ) Pair by value, so it is only an input iterator.
+template< typename NodeTy, typename CharTy >
+class TrieIterator
+{
+public:
+  typedef typename NodeTy::Allocator Allocator;
+  typedef typename Allocator::template Pointer< NodeTy > NodePtr;
+  typedef typename NodeTy::Pair Pair;
+
+  typedef std::input_iterator_tag iterator_category;
+  typedef Pair value_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef Pair const* pointer;
+  typedef Pair const reference;
+
+  #pragma region Constructors
+  // The end iterator
+  TrieIterator()
+    : m_stack {}, m_key {}, m_minKeyLength { 0ULL }
+  {
+
+  }
+  #pragma endregion
+
+  #pragma region Operator Overrides
+  reference operator*() const
+  {
+    return Pair( m_key, GetNode() );
+  }
+
+  TrieIterator& operator++()
+  {
+    Advance();
+    return *this;
+  }
+
+  TrieIterator operator++( int )
+  {
+    auto const ret { *this };
+    Advance();
+    return ret;
+  }
+
+  bool const operator==( TrieIterator const& rhs ) const
+  {
+    return m_stack.empty() ? rhs.m_stack.empty() : ( !rhs.m_stack.empty() && m_stack.back().node == rhs.m_stack.back().node );
+  }
+
+  bool const operator!=( TrieIterator const& rhs ) const
+  {
+    return !operator==( rhs );
+  }
+  #pragma endregion
+
+  std::basic_string< CharTy > const& GetKey() const
+  {
+    return m_key;
+  }
+
+  NodePtr const GetNode() const
+  {
+    return Allocator::template Cast< NodeTy >( *m_stack.back().link );
+  }
+
+  // The first entry of root not less than str. With minKeyLength set, the
+  // iterator ends at the first entry which does not start with the first
+  // minKeyLength characters of str.
+  template< typename NodePtrTy >
+  static TrieIterator const LowerBound( NodePtrTy const& root, std::basic_string< CharTy > const& str, size_t const minKeyLength = 0ULL )
+  {
+    TrieIterator it;
+    if( root == nullptr )
+    {
+      return it;
+    }
+
+    it.m_minKeyLength = minKeyLength;
+    it.m_stack.push_back( { Allocator::Raw( root ), nullptr, 0ULL, 0ULL } );
+
+    // walk down str, every frame left on the stack resumes after str's branch
+    int cmp { 0 };
+    for( size_t depth { 0ULL }; cmp == 0 && depth < str.size(); )
+    {
+      auto& top { it.m_stack.back() };
+      auto const charIndex { NodeTy::CharIndex( str[depth] ) };
+      if( charIndex >= NodeTy::NumChars )
+      {
+        // outside the alphabet, so resume at the first child after it
+        top.nextChild = NextChildAfter( *top.node, str[depth] );
+        return it.Positioned( str, false );
+      }
+      auto childIndex { charIndex };
+      auto const link { top.node->GetNextChild( childIndex ) };
+      if( link == nullptr || childIndex != charIndex )
+      {
+        top.nextChild = charIndex;
+        return it.Positioned( str, false );
+      }
+
+      top.nextChild = charIndex + 1ULL;
+      auto const child { static_cast< NodeTy const* >( Allocator::Raw( *link ) ) };
+      cmp = NodeTy::CompareEdge( *child, str, depth );
+      if( cmp < 0 )
+      {
+        return it.Positioned( str, false );
+      }
+      NodeTy::AppendEdge( *child, it.m_key );
+      it.m_stack.push_back( { child, link, 0ULL, it.m_key.size() } );
+    }
+
+    return it.Positioned( str, it.m_stack.size() > 1ULL && it.m_stack.back().node->IsEndOfAnEntry() );
+  }
+
+private:
+  struct Frame
+  {
+    NodeTy const* node;
+    typename NodeTy::NodePtr const* link;
+    size_t nextChild;
+    size_t keyLength;
+  };
+
+  std::vector< Frame > m_stack;
+  std::basic_string< CharTy > m_key;
+  size_t m_minKeyLength;
+
+  TrieIterator const& Positioned( std::basic_string< CharTy > const& str, bool const atEntry )
+  {
+    if( !atEntry )
+    {
+      Advance();
+    }
+    if( !m_stack.empty() && m_key.compare( 0ULL, m_minKeyLength, str, 0ULL, m_minKeyLength ) != 0 )
+    {
+      m_stack.clear();
+    }
+    return *this;
+  }
+
+  // The index of node's first child whose character orders after c, which
+  // is not in the alphabet, or NumChars if there is none
+  static size_t const NextChildAfter( NodeTy const& node, CharTy const c )
+  {
+    typedef typename std::make_unsigned< CharTy >::type UnsignedTy;
+    size_t index { 0ULL };
+    for( auto child { node.GetNextChild( index ) }; child != nullptr; child = node.GetNextChild( ++index ) )
+    {
+      if( static_cast< UnsignedTy >( c ) < static_cast< UnsignedTy >( ( *child )->GetChar() ) )
+      {
+        return index;
+      }
+    }
+    return NodeTy::NumChars;
+  }
+
+  // Moves to the next entry in preorder. A frame whose key is shorter than
+  // m_minKeyLength is an ancestor of the range, so any child it has left
+  // lies past the range.
+  void Advance()
+  {
+    while( !m_stack.empty() )
+    {
+      auto& top { m_stack.back() };
+      m_key.resize( top.keyLength );
+      auto const link { ( top.keyLength < m_minKeyLength ) ? nullptr : top.node->GetNextChild( top.nextChild ) };
+      if( link == nullptr )
+      {
+        m_stack.pop_back();
+        continue;
+      }
+
+      ++top.nextChild;
+      auto const child { static_cast< NodeTy const* >( Allocator::Raw( *link ) ) };
+      NodeTy::AppendEdge( *child, m_key );
+      m_stack.push_back( { child, link, 0ULL, m_key.size() } );
+      if( child->IsEndOfAnEntry() )
+      {
+        return;
+      }
+    }
+    m_key.clear();
+  }
+};
+
+// Pair of iterators usable in a range-based for
+template< typename IterTy >
+class TrieRange
+{
+public:
+  TrieRange( IterTy first, IterTy last )
+    : m_first { std::move( first ) }, m_last { std::move( last ) }
+  {
+
+  }
+
+  IterTy const& begin() const
+  {
+    return m_first;
+  }
+
+  IterTy const& end() const
+  {
+    return m_last;
+  }
+
+private:
+  IterTy m_first;
+  IterTy m_last;
+};
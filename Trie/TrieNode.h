@@ -24,260 +24,907 @@
 #include <limits>
 #include <type_traits>
 #include <utility>
-
-template< typename CharTy >
+#include "TrieNodeChildren.h"
+#include "TrieNodeAllocator.h"
+#include "TriePattern.h"
+#include "Alphabet.h"
+#include "TrieStats.h"
+#include "TrieInstrumentation.h"
+
+// AlphabetTy maps characters to child indexes, see Alphabet.h. Keys with a
+// character outside it are never inserted or found. InstrumentTy records
+// Find, Insert and Remove, see TrieInstrumentation.h.
+template< typename CharTy, typename AllocTy = SharedNodeAllocator, typename AlphabetTy = FullAlphabet< CharTy >, typename InstrumentTy = NoTrieInstrumentation >
 class TrieNode
 {
 public:
-  static constexpr size_t NumChars = 1ULL << 8ULL * sizeof( CharTy );
-  typedef std::pair < std::basic_string< CharTy >, std::shared_ptr< TrieNode< CharTy > > const > Pair;
+  static constexpr size_t NumChars = AlphabetTy::Size;
+  static constexpr size_t BatchWidth = 16ULL;
+  // bytes of each node taken by its DataTy, see DataTrieNode
+  static constexpr size_t PayloadBytes = 0ULL;
+  typedef AllocTy Allocator;
+  typedef AlphabetTy Alphabet;
+  typedef InstrumentTy Instrumentation;
+  typedef typename AllocTy::template Pointer< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy > > NodePtr;
+  typedef TrieNodeChildren< NodePtr, NumChars > Children;
+  typedef std::pair < std::basic_string< CharTy >, NodePtr const > Pair;
+
+  template< typename NodePtrTy >
+  using NodeOf = typename std::pointer_traits< typename std::decay< NodePtrTy >::type >::element_type;
 
   #pragma region Constructors
   TrieNode( CharTy const charVal )
-    : m_char { charVal }, m_isEndOfAnEntry { false }, m_numChildren { 0ULL }
+    : m_char { charVal }, m_isEndOfAnEntry { false }
   {
     static_assert( std::is_integral< CharTy >::value, "Must use an integral type for CharTy" );
-    m_children.resize( NumChars );
   }
   TrieNode() : TrieNode( static_cast<CharTy>( 0 ) ) {}
   #pragma endregion
 
   #pragma region Static Operations
-  template< typename NodeTy >
-  static std::shared_ptr < NodeTy > const CloneSubTrie( NodeTy const& root )
+  template< typename NodePtrTy, typename ArenaTy >
+  static NodePtrTy const CloneSubTrie( NodePtrTy const& root, ArenaTy& arena )
   {
-    auto ret { std::make_shared< NodeTy >( root ) };
-    for( CharTy c { 0ULL }; c < NumChars; ++c )
+    typedef NodeOf< NodePtrTy > NodeTy;
+    if( root == nullptr )
     {
-      auto const& rhsChild { root.GetChild( c ) };
-      if( rhsChild != nullptr )
-      {
-        ret->AddChild( CloneSubTrie( rhsChild ) );
-      }
+      return NodePtrTy();
+    }
+
+    NodePtrTy ret { arena.Create( *root ) };
+    ret->m_children.Clear();
+    if( ret->m_isEndOfAnEntry )
+    {
+      arena.AddEntries( 1 );
     }
+    root->m_children.ForEach( [&ret, &arena]( size_t const, NodePtr const& rhsChild )
+    {
+      ret->AddChild( CloneSubTrie( AllocTy::template Cast< NodeTy >( rhsChild ), arena ) );
+    } );
 
-    return std::move( ret );
+    return ret;
   }
 
-  template< typename NodeTy >
-  static std::shared_ptr < NodeTy > const CloneSubTrie( std::shared_ptr< NodeTy > const& root )
+  template< typename NodePtrTy, typename ArenaTy >
+  static void ReleaseSubTrie( NodePtrTy const& root, ArenaTy& arena )
   {
-    return (root == nullptr) ? nullptr : CloneSubTrie( *root );
+    typedef NodeOf< NodePtrTy > NodeTy;
+    if( !AllocTy::ManualRelease || root == nullptr )
+    {
+      return;
+    }
+
+    std::vector< NodePtrTy > pending { root };
+    while( !pending.empty() )
+    {
+      auto const node { pending.back() };
+      pending.pop_back();
+      node->m_children.ForEach( [&pending]( size_t const, NodePtr const& child )
+      {
+        pending.push_back( AllocTy::template Cast< NodeTy >( child ) );
+      } );
+      arena.Destroy( node );
+    }
   }
 
-  template< typename NodeTy, typename IterTy >
-  static std::shared_ptr < NodeTy > const Find( std::shared_ptr< NodeTy > const& root, IterTy&& begin, IterTy&& end )
+  template< typename NodePtrTy, typename IterTy >
+  static NodePtrTy const Find( NodePtrTy const& root, IterTy&& begin, IterTy&& end )
   {
-    static_assert( std::is_base_of< TrieNode< CharTy >, NodeTy >::value, "Must use a TrieNode type" );
+    typedef NodeOf< NodePtrTy > NodeTy;
+    static_assert( std::is_base_of< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >, NodeTy >::value, "Must use a TrieNode type" );
+    typename InstrumentTy::Scope scope { TrieOperation::Find };
     if( root == nullptr )
     {
-      return std::shared_ptr< NodeTy >();
+      return NodePtrTy();
     }
 
-    auto curNode { root };
+    // walk raw pointers, only the final link is converted back to a handle
+    TrieNode const* curNode { AllocTy::Raw( root ) };
+    NodePtr const* curLink { nullptr };
     for( IterTy it { begin }; it != end; ++it )
     {
-      curNode = std::static_pointer_cast< NodeTy >( curNode->GetChild( *it ) );
-      if( curNode == nullptr )
+      curLink = &curNode->GetChild( *it );
+      if( *curLink == nullptr )
       {
-        break;
+        return NodePtrTy();
       }
+      curNode = AllocTy::Raw( *curLink );
+      scope.Visit();
+    }
 
-      auto nextIt { it };
-      ++nextIt;
-      auto const& isLastChar { nextIt == end };
-      auto const& isSameChar { curNode->m_char == *it };
-
-      if( curNode->m_isEndOfAnEntry && isLastChar && isSameChar )
-      {
-        return curNode;
-      }
-      else if( !isSameChar )
-      {
-        break;
-      }
+    if( curLink != nullptr && curNode->m_isEndOfAnEntry )
+    {
+      scope.Hit();
+      return AllocTy::template Cast< NodeTy >( *curLink );
     }
 
-    return std::shared_ptr< NodeTy >();
+    return NodePtrTy();
   }
 
-  template< typename NodeTy, typename IterTy >
-  static std::shared_ptr < NodeTy > const Insert( std::shared_ptr< NodeTy > const& root, IterTy&& begin, IterTy&& end )
+  template< typename NodePtrTy, typename IterTy, typename ArenaTy >
+  static NodePtrTy const Insert( NodePtrTy const& root, IterTy&& begin, IterTy&& end, ArenaTy& arena )
   {
-    static_assert( std::is_base_of< TrieNode< CharTy >, NodeTy >::value, "Must use a TrieNode type" );
-    if( root == nullptr || begin == end )
+    bool inserted { false };
+    return InsertEntry( root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ), arena, inserted, [&arena]( CharTy const c )
     {
-      return std::shared_ptr< NodeTy >();
-    }
+      return arena.Create( c );
+    } );
+  }
 
-    auto curNode { root };
-    auto lastNode { root };
-    for( IterTy it { begin }; it != end; ++it )
+  // Insert, creating the key's last node with createLast( c ) if it does not
+  // exist yet. inserted is set if the key was not already an entry.
+  template< typename NodePtrTy, typename IterTy, typename ArenaTy, typename CreateTy >
+  static NodePtrTy const InsertEntry( NodePtrTy const& root, IterTy&& begin, IterTy&& end, ArenaTy& arena, bool& inserted, CreateTy&& createLast )
+  {
+    typedef NodeOf< NodePtrTy > NodeTy;
+    static_assert( std::is_base_of< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >, NodeTy >::value, "Must use a TrieNode type" );
+    typename InstrumentTy::Scope scope { TrieOperation::Insert };
+    inserted = false;
+    if( root == nullptr || begin == end || !InAlphabet( begin, end ) )
     {
-      curNode = std::static_pointer_cast< NodeTy >( curNode->GetChild( *it ) );
+      return NodePtrTy();
+    }
 
-      if( curNode == nullptr )
+    NodeTy* curNode { AllocTy::Raw( root ) };
+    NodePtr const* curLink { nullptr };
+    for( IterTy it { begin }; it != end; )
+    {
+      auto const c { *it };
+      auto const isLast { ++it == end };
+      curLink = &curNode->GetChild( c );
+      if( *curLink == nullptr )
       {
-        curNode = std::make_shared< NodeTy >( *it );
-        lastNode->AddChild( curNode );
+        curNode->AddChild( isLast ? createLast( c ) : arena.Create( c ) );
+        curLink = &curNode->GetChild( c );
+        scope.Allocate();
       }
-      lastNode = curNode;
+      curNode = static_cast< NodeTy* >( AllocTy::Raw( *curLink ) );
+      scope.Visit();
     }
 
-    lastNode->m_isEndOfAnEntry = true;
+    if( !curNode->m_isEndOfAnEntry )
+    {
+      inserted = true;
+      scope.Hit();
+    }
+    SetEndOfAnEntry( *curNode, true, arena );
 
-    return lastNode;
+    return AllocTy::template Cast< NodeTy >( *curLink );
   }
 
-  template< typename NodeTy, typename IterTy >
-  static std::shared_ptr < NodeTy > const Remove( std::shared_ptr< NodeTy > const& root, IterTy&& begin, IterTy&& end )
+  template< typename NodePtrTy, typename IterTy, typename ArenaTy >
+  static NodePtrTy const Remove( NodePtrTy const& root, IterTy&& begin, IterTy&& end, ArenaTy& arena )
   {
-    static_assert(std::is_base_of< TrieNode< CharTy >, NodeTy >::value, "Must use a TrieNode type");
+    typedef NodeOf< NodePtrTy > NodeTy;
+    static_assert(std::is_base_of< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >, NodeTy >::value, "Must use a TrieNode type");
+    typename InstrumentTy::Scope scope { TrieOperation::Remove };
     if( root == nullptr || begin == end )
     {
-      return std::shared_ptr< NodeTy >();
+      return NodePtrTy();
     }
 
-    std::shared_ptr< NodeTy > lastEntryEnd { root };
+    NodeTy* lastEntryEnd { AllocTy::Raw( root ) };
+    NodePtr const* lastEntryEndLink { nullptr };
     CharTy nearestCharToLastEntryEnd { *begin };
 
-    auto curNode { root };
+    NodeTy* curNode { lastEntryEnd };
     for( IterTy it { begin }; it != end; ++it )
     {
-      curNode = std::static_pointer_cast< NodeTy >( curNode->GetChild( *it ) );
-      if( curNode == nullptr )
+      auto const& curLink { curNode->GetChild( *it ) };
+      if( curLink == nullptr )
       {
         break;
       }
+      curNode = static_cast< NodeTy* >( AllocTy::Raw( curLink ) );
+      scope.Visit();
 
       auto nextIt { it };
       ++nextIt;
 
       auto const& isLastChar { nextIt == end };
-      auto const& isSameChar { curNode->m_char == *it };
 
-      if( curNode->m_isEndOfAnEntry && isLastChar && isSameChar )
+      if( curNode->m_isEndOfAnEntry && isLastChar )
       {
-        curNode->m_isEndOfAnEntry = false;
+        scope.Hit();
+        SetEndOfAnEntry( *curNode, false, arena );
         if( curNode->GetNumChildren() == 0 )
         {
+          auto const trimmed { AllocTy::template Cast< NodeTy >( lastEntryEnd->GetChild( nearestCharToLastEntryEnd ) ) };
           lastEntryEnd->RemoveChild( nearestCharToLastEntryEnd );
+          ReleaseSubTrie( trimmed, arena );
         }
-        return lastEntryEnd;
-      }
-      else if( !isSameChar )
-      {
-        break;
+        return ( lastEntryEndLink == nullptr ) ? root : AllocTy::template Cast< NodeTy >( *lastEntryEndLink );
       }
 
       if( (curNode->m_isEndOfAnEntry || (curNode->GetNumChildren() > 1 ) ) && !isLastChar )
       {
         lastEntryEnd = curNode;
+        lastEntryEndLink = &curLink;
         nearestCharToLastEntryEnd = *nextIt;
       }
     }
 
-    return std::shared_ptr< NodeTy >();
+    return NodePtrTy();
   }
 
-  template< typename NodeTy, typename IterTy >
-  static bool const HasString( std::shared_ptr< NodeTy > const& root, IterTy&& begin, IterTy&& end )
+  // Appends [begin, end) below path.back() for a key known to share nothing
+  // more with the trie, so no lookups are needed. Each new node's child
+  // storage is sized from the next *numChildren.
+  template< typename NodeTy, typename IterTy, typename ArenaTy, typename CountIterTy >
+  static NodeTy* const AppendBelow( std::vector< NodeTy* >& path, IterTy begin, IterTy const& end, ArenaTy& arena, CountIterTy& numChildren )
   {
-    static_assert( std::is_base_of< TrieNode< CharTy >, NodeTy >::value, "Must use a TrieNode type" );
-    auto& node { Find( root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ) ) };
-    return node != nullptr;
+    static_assert( std::is_base_of< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >, NodeTy >::value, "Must use a TrieNode type" );
+
+    NodeTy* curNode { path.back() };
+    for( ; begin != end; ++begin )
+    {
+      auto const child { arena.Create( *begin ) };
+      child->ReserveChildren( *numChildren++ );
+      curNode->AddChild( child );
+      curNode = static_cast< NodeTy* >( AllocTy::Raw( child ) );
+      path.push_back( curNode );
+    }
+
+    SetEndOfAnEntry( *curNode, true, arena );
+
+    return curNode;
   }
 
-  template< typename NodeTy >
-  static void GetAllStrings( std::shared_ptr< NodeTy > const& root, std::vector< std::basic_string< CharTy > >& strings )
+  // Inserts [begin, end) below path.back(), pushing every node it passes onto
+  // path so the next key can start from any node along it
+  template< typename NodeTy, typename IterTy, typename ArenaTy >
+  static NodeTy* const InsertBelow( std::vector< NodeTy* >& path, IterTy begin, IterTy const& end, ArenaTy& arena )
   {
-    static_assert( std::is_base_of< TrieNode< CharTy >, NodeTy >::value, "Must use a TrieNode type" );
+    static_assert( std::is_base_of< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >, NodeTy >::value, "Must use a TrieNode type" );
 
-    std::basic_string< CharTy > intialStr {};
-    for( auto const& child : root->m_children )
+    NodeTy* curNode { path.back() };
+    for( ; begin != end; ++begin )
     {
-      if( child != nullptr )
+      auto curLink { &curNode->GetChild( *begin ) };
+      if( *curLink == nullptr )
       {
-        GetAllStrings( child, intialStr, strings );
+        curNode->AddChild( arena.Create( *begin ) );
+        curLink = &curNode->GetChild( *begin );
       }
+      curNode = static_cast< NodeTy* >( AllocTy::Raw( *curLink ) );
+      path.push_back( curNode );
+    }
+
+    SetEndOfAnEntry( *curNode, true, arena );
+
+    return curNode;
+  }
+
+  // Copies the nodes on the path to the entry instead of modifying them and
+  // returns the new root, every other node is shared with root
+  template< typename NodePtrTy, typename IterTy, typename ArenaTy >
+  static NodePtrTy const PathCopyInsert( NodePtrTy const& root, IterTy&& begin, IterTy&& end, ArenaTy& arena, NodePtrTy& entry )
+  {
+    typedef NodeOf< NodePtrTy > NodeTy;
+    typedef typename std::decay< IterTy >::type IterValTy;
+    static_assert( std::is_base_of< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >, NodeTy >::value, "Must use a TrieNode type" );
+    if( root == nullptr || begin == end )
+    {
+      return NodePtrTy();
+    }
+
+    NodePtrTy const newRoot { arena.Create( *root ) };
+    NodePtrTy curNode { newRoot };
+    for( IterValTy it { begin }; it != end; ++it )
+    {
+      auto const& child { curNode->GetChild( *it ) };
+      NodePtrTy const copy { ( child == nullptr ) ? arena.Create( *it ) : arena.Create( static_cast< NodeTy const& >( *child ) ) };
+      curNode->AddChild( copy );
+      curNode = copy;
     }
+
+    curNode->m_isEndOfAnEntry = true;
+    entry = curNode;
+
+    return newRoot;
   }
 
-  template< typename NodeTy >
-  static void GetAllStringsWithNodes( std::shared_ptr< NodeTy > const& root, std::vector< typename NodeTy::Pair >& stringsWithNodes )
+  // Returns a new root without the entry, or nullptr if root does not contain it
+  template< typename NodePtrTy, typename IterTy, typename ArenaTy >
+  static NodePtrTy const PathCopyRemove( NodePtrTy const& root, IterTy&& begin, IterTy&& end, ArenaTy& arena )
+  {
+    typedef NodeOf< NodePtrTy > NodeTy;
+    typedef typename std::decay< IterTy >::type IterValTy;
+    static_assert( std::is_base_of< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >, NodeTy >::value, "Must use a TrieNode type" );
+    if( Find( root, IterValTy { begin }, IterValTy { end } ) == nullptr )
+    {
+      return NodePtrTy();
+    }
+
+    std::vector< NodePtrTy > path { arena.Create( *root ) };
+    for( IterValTy it { begin }; it != end; ++it )
+    {
+      NodePtrTy const copy { arena.Create( static_cast< NodeTy const& >( *path.back()->GetChild( *it ) ) ) };
+      path.back()->AddChild( copy );
+      path.push_back( copy );
+    }
+
+    path.back()->m_isEndOfAnEntry = false;
+    for( auto i { path.size() - 1ULL }; i > 0ULL && !path[i]->m_isEndOfAnEntry && path[i]->GetNumChildren() == 0ULL; --i )
+    {
+      path[i - 1ULL]->RemoveChild( path[i]->m_char );
+    }
+
+    return path.front();
+  }
+
+  // Looks up every string in [first, last), walking up to BatchWidth of them
+  // in lock-step. Each round prefetches the next child of every string before
+  // reading any of them, so their cache misses overlap instead of queueing.
+  // Calls fn( i, link ) with the link to the i-th string's entry, or nullptr,
+  // in no particular order.
+  template< typename NodePtrTy, typename IterTy, typename FnTy >
+  static void FindBatch( NodePtrTy const& root, IterTy first, IterTy const& last, FnTy&& fn )
+  {
+    typedef NodeOf< NodePtrTy > NodeTy;
+    static_assert( std::is_base_of< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >, NodeTy >::value, "Must use a TrieNode type" );
+
+    // node is read the round after it was reached, once its prefetch has landed
+    struct Cursor
+    {
+      std::basic_string< CharTy > const* str;
+      size_t index;
+      size_t depth;
+      NodeTy const* node;
+      NodePtr const* link;
+    };
+
+    Cursor cursors[BatchWidth];
+    for( size_t index { 0ULL }; first != last; )
+    {
+      size_t numActive { 0ULL };
+      for( ; numActive < BatchWidth && first != last; ++first, ++index )
+      {
+        if( root == nullptr || first->empty() )
+        {
+          fn( index, static_cast< NodePtr const* >( nullptr ) );
+          continue;
+        }
+        cursors[numActive++] = { &*first, index, 0ULL, AllocTy::Raw( root ), nullptr };
+      }
+
+      while( numActive > 0ULL )
+      {
+        for( size_t i { 0ULL }; i < numActive; )
+        {
+          auto& cursor { cursors[i] };
+          auto const matched { cursor.link == nullptr || NodeTy::CompareEdge( *cursor.node, *cursor.str, cursor.depth ) == 0 };
+          if( !matched || cursor.depth == cursor.str->size() )
+          {
+            fn( cursor.index, ( matched && cursor.node->m_isEndOfAnEntry ) ? cursor.link : nullptr );
+            cursor = cursors[--numActive];
+            continue;
+          }
+          cursor.node->m_children.Prefetch( CharIndex( ( *cursor.str )[cursor.depth] ) );
+          ++i;
+        }
+
+        for( size_t i { 0ULL }; i < numActive; )
+        {
+          auto& cursor { cursors[i] };
+          cursor.link = &cursor.node->GetChild( ( *cursor.str )[cursor.depth] );
+          if( *cursor.link == nullptr )
+          {
+            fn( cursor.index, static_cast< NodePtr const* >( nullptr ) );
+            cursor = cursors[--numActive];
+            continue;
+          }
+          cursor.node = static_cast< NodeTy const* >( AllocTy::Raw( *cursor.link ) );
+          TRIE_PREFETCH( cursor.node );
+          ++i;
+        }
+      }
+    }
+  }
+
+  // Calls fn( length, link ) for every entry which is a prefix of
+  // [begin, end), shortest first, walking the input once
+  template< typename NodePtrTy, typename IterTy, typename FnTy >
+  static void ForEachPrefixOf( NodePtrTy const& root, IterTy begin, IterTy const& end, FnTy&& fn )
+  {
+    typedef NodeOf< NodePtrTy > NodeTy;
+    static_assert( std::is_base_of< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >, NodeTy >::value, "Must use a TrieNode type" );
+    if( root == nullptr )
+    {
+      return;
+    }
+
+    NodeTy const* curNode { AllocTy::Raw( root ) };
+    size_t length { 0ULL };
+    while( begin != end )
+    {
+      auto const& link { curNode->GetChild( *begin ) };
+      if( link == nullptr )
+      {
+        return;
+      }
+      curNode = static_cast< NodeTy const* >( AllocTy::Raw( link ) );
+
+      auto const edgeLength { NodeTy::ConsumeEdge( *curNode, begin, end ) };
+      if( edgeLength == 0ULL )
+      {
+        return;
+      }
+      length += edgeLength;
+      if( curNode->m_isEndOfAnEntry )
+      {
+        fn( length, link );
+      }
+    }
+  }
+
+  // Calls fn( key, link, distance ) for every entry within maxDistance edits
+  // of query, in key order, until fn returns false. The walk is depth first
+  // with one Levenshtein row per key character, and a subtree is skipped as
+  // soon as every cell of its row exceeds maxDistance.
+  template< typename NodePtrTy, typename FnTy >
+  static void FuzzyFind( NodePtrTy const& root, std::basic_string< CharTy > const& query, size_t const maxDistance, FnTy&& fn )
   {
-    static_assert( std::is_base_of< TrieNode< CharTy >, NodeTy >::value, "Must use a TrieNode type" );
+    typedef NodeOf< NodePtrTy > NodeTy;
+    static_assert( std::is_base_of< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >, NodeTy >::value, "Must use a TrieNode type" );
+    if( root == nullptr )
+    {
+      return;
+    }
+
+    // row d holds the distances between key[0, d) and the prefixes of query
+    auto const width { query.size() + 1ULL };
+    std::vector< size_t > rows( width );
+    for( size_t i { 0ULL }; i < width; ++i )
+    {
+      rows[i] = i;
+    }
+
+    // ( link, length of the key above it ), children pushed in reverse order
+    std::vector< std::pair< NodePtr const*, size_t > > pending;
+    auto const pushChildren = [&pending]( NodeTy const& node, size_t const keyLength )
+    {
+      auto const numPending { pending.size() };
+      node.ForEachChild( [&pending, keyLength]( NodePtr const& child )
+      {
+        pending.push_back( { &child, keyLength } );
+      } );
+      std::reverse( pending.begin() + static_cast< std::ptrdiff_t >( numPending ), pending.end() );
+    };
+    pushChildren( *AllocTy::Raw( root ), 0ULL );
+
+    std::basic_string< CharTy > key;
+    while( !pending.empty() )
+    {
+      auto const link { pending.back().first };
+      auto const parentLength { pending.back().second };
+      pending.pop_back();
+
+      auto const node { static_cast< NodeTy const* >( AllocTy::Raw( *link ) ) };
+      key.resize( parentLength );
+      NodeTy::AppendEdge( *node, key );
+      rows.resize( ( key.size() + 1ULL ) * width );
+
+      auto withinBound { true };
+      for( auto depth { parentLength + 1ULL }; withinBound && depth <= key.size(); ++depth )
+      {
+        withinBound = NextRow( &rows[( depth - 1ULL ) * width], &rows[depth * width], query, key[depth - 1ULL], depth, maxDistance ) <= maxDistance;
+      }
+      if( !withinBound )
+      {
+        continue;
+      }
+
+      // the last cell is only computed when it lies in the band
+      auto const inBand { key.size() <= query.size() + maxDistance && query.size() <= key.size() + maxDistance };
+      size_t const distance { inBand ? rows[key.size() * width + query.size()] : maxDistance + 1ULL };
+      if( node->m_isEndOfAnEntry && distance <= maxDistance && !fn( key, *link, distance ) )
+      {
+        return;
+      }
+      pushChildren( *node, key.size() );
+    }
+  }
+
+  // Calls fn( key, link ) for every entry matching pattern, in key order.
+  // Each node carries the pattern positions its key can be at, and only
+  // children some position accepts are visited: literals are looked up
+  // directly, classes enumerate their ranges, and only ?, * and negated
+  // classes enumerate every child.
+  template< typename NodePtrTy, typename FnTy >
+  static void Match( NodePtrTy const& root, TriePattern< CharTy > const& pattern, FnTy&& fn )
+  {
+    typedef NodeOf< NodePtrTy > NodeTy;
+    typedef typename TriePattern< CharTy >::Kind Kind;
+    static_assert( std::is_base_of< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >, NodeTy >::value, "Must use a TrieNode type" );
+    if( root == nullptr )
+    {
+      return;
+    }
+
+    // the positions before a frame's edge are pool[positionsBegin, positionsEnd),
+    // shared by siblings and stacked in the same order as the frames
+    struct Frame
+    {
+      NodePtr const* link;
+      size_t keyLength;
+      size_t positionsBegin;
+      size_t positionsEnd;
+    };
+    std::vector< Frame > pending;
+    std::vector< size_t > pool;
+    std::vector< size_t > positions;
+    std::vector< size_t > next;
+    std::vector< std::pair< size_t, NodePtr const* > > children;
+    std::basic_string< CharTy > key;
+
+    auto const pushChildren = [&]( NodeTy const& node )
+    {
+      children.clear();
+      auto const anyChild { std::any_of( positions.begin(), positions.end(), [&pattern]( size_t const pos )
+      {
+        if( pos == pattern.GetNumTokens() )
+        {
+          return false;
+        }
+        auto const& token { pattern.GetToken( pos ) };
+        // class ranges are over characters, not an alphabet's indexes
+        return token.kind == Kind::Any || token.kind == Kind::Star || ( token.kind == Kind::Class && ( token.negated || !AlphabetTy::IsFull ) );
+      } ) };
+
+      if( anyChild )
+      {
+        node.m_children.ForEach( [&children]( size_t const index, NodePtr const& child )
+        {
+          children.push_back( { index, &child } );
+        } );
+      }
+      else
+      {
+        for( auto const pos : positions )
+        {
+          if( pos == pattern.GetNumTokens() )
+          {
+            continue;
+          }
+          auto const& token { pattern.GetToken( pos ) };
+          if( token.kind == Kind::Literal )
+          {
+            auto const& child { node.GetChild( token.literal ) };
+            if( child != nullptr )
+            {
+              children.push_back( { CharIndex( token.literal ), &child } );
+            }
+            continue;
+          }
+          for( auto const& range : token.ranges )
+          {
+            for( auto index { range.first }; index <= range.second; ++index )
+            {
+              auto const child { node.GetNextChild( index ) };
+              if( child == nullptr || index > range.second )
+              {
+                break;
+              }
+              children.push_back( { index, child } );
+            }
+          }
+        }
+        std::sort( children.begin(), children.end() );
+        children.erase( std::unique( children.begin(), children.end() ), children.end() );
+      }
+
+      if( children.empty() )
+      {
+        return;
+      }
+      auto const positionsBegin { pool.size() };
+      pool.insert( pool.end(), positions.begin(), positions.end() );
+      for( auto it { children.rbegin() }; it != children.rend(); ++it )
+      {
+        pending.push_back( { it->second, key.size(), positionsBegin, pool.size() } );
+      }
+    };
+
+    pattern.Start( positions );
+    pushChildren( *AllocTy::Raw( root ) );
+    while( !pending.empty() )
+    {
+      auto const frame { pending.back() };
+      pending.pop_back();
+      positions.assign( pool.begin() + static_cast< std::ptrdiff_t >( frame.positionsBegin ), pool.begin() + static_cast< std::ptrdiff_t >( frame.positionsEnd ) );
+      pool.resize( frame.positionsEnd );
+
+      auto const node { static_cast< NodeTy const* >( AllocTy::Raw( *frame.link ) ) };
+      key.resize( frame.keyLength );
+      NodeTy::AppendEdge( *node, key );
+      for( auto i { frame.keyLength }; !positions.empty() && i < key.size(); ++i )
+      {
+        pattern.Step( positions, key[i], next );
+        positions.swap( next );
+      }
+      if( positions.empty() )
+      {
+        continue;
+      }
+
+      if( node->m_isEndOfAnEntry && pattern.IsAccepting( positions ) )
+      {
+        fn( key, *frame.link );
+      }
+      pushChildren( *node );
+    }
+  }
+
+  // Advances it past the edge into node and returns its length, or returns
+  // 0 if [it, end) does not continue with the whole edge. The first
+  // character is already known to match.
+  template< typename IterTy >
+  static size_t const ConsumeEdge( TrieNode const&, IterTy& it, IterTy const& )
+  {
+    ++it;
+    return 1ULL;
+  }
+
+  // Compares the edge into node with str from depth, where the first
+  // character is already known to match. Returns 0 and consumes the edge if
+  // str continues with all of it, otherwise the sign of edge - str.
+  static int const CompareEdge( TrieNode const&, std::basic_string< CharTy > const&, size_t& depth )
+  {
+    ++depth;
+    return 0;
+  }
+
+  static void AppendEdge( TrieNode const& node, std::basic_string< CharTy >& str )
+  {
+    str.push_back( node.m_char );
+  }
+
+  // Number of characters on the edge into node
+  static size_t const GetEdgeLength( TrieNode const& )
+  {
+    return 1ULL;
+  }
+
+  // Bytes the edge into node is stored in outside the node
+  static size_t const GetEdgeBytes( TrieNode const& )
+  {
+    return 0ULL;
+  }
+
+  template< typename NodePtrTy, typename IterTy >
+  static bool const HasString( NodePtrTy const& root, IterTy&& begin, IterTy&& end )
+  {
+    return Find( root, std::forward< IterTy >( begin ), std::forward< IterTy >( end ) ) != nullptr;
+  }
+
+  template< typename NodePtrTy >
+  static void GetAllStrings( NodePtrTy const& root, std::vector< std::basic_string< CharTy > >& strings )
+  {
+    static_assert( std::is_base_of< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >, NodeOf< NodePtrTy > >::value, "Must use a TrieNode type" );
 
     std::basic_string< CharTy > intialStr {};
-    for( auto const& child : root->m_children )
+    root->m_children.ForEach( [&]( size_t const, NodePtr const& child )
     {
-      auto derived { std::static_pointer_cast< NodeTy >( child ) };
-      if( derived != nullptr )
+      GetAllStrings( child, intialStr, strings );
+    } );
+  }
+
+  template< typename NodePtrTy >
+  static void GetAllStringsWithNodes( NodePtrTy const& root, std::vector< typename NodeOf< NodePtrTy >::Pair >& stringsWithNodes )
+  {
+    typedef NodeOf< NodePtrTy > NodeTy;
+    static_assert( std::is_base_of< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >, NodeTy >::value, "Must use a TrieNode type" );
+
+    std::basic_string< CharTy > intialStr {};
+    root->m_children.ForEach( [&]( size_t const, NodePtr const& child )
+    {
+      GetAllStringsWithNodes( AllocTy::template Cast< NodeTy >( child ), intialStr, stringsWithNodes );
+    } );
+  }
+  // Fills stats in one pass over every node, without recursion
+  template< typename NodePtrTy >
+  static void GetStats( NodePtrTy const& root, TrieStats& stats )
+  {
+    typedef NodeOf< NodePtrTy > NodeTy;
+    static_assert( std::is_base_of< TrieNode< CharTy, AllocTy, AlphabetTy, InstrumentTy >, NodeTy >::value, "Must use a TrieNode type" );
+
+    stats = TrieStats {};
+    if( root == nullptr )
+    {
+      return;
+    }
+
+    struct Pending
+    {
+      NodeTy const* node;
+      size_t depth;
+      size_t keyLength;
+    };
+    std::vector< Pending > pending { { AllocTy::Raw( root ), 0ULL, 0ULL } };
+    while( !pending.empty() )
+    {
+      auto const cur { pending.back() };
+      pending.pop_back();
+
+      auto const& node { *cur.node };
+      auto const numChildren { node.GetNumChildren() };
+      ++stats.numNodes;
+      stats.nodeBytes += sizeof( NodeTy ) - NodeTy::PayloadBytes + NodeTy::GetEdgeBytes( node );
+      stats.childBytes += node.m_children.GetHeapBytes();
+      stats.dataBytes += NodeTy::PayloadBytes;
+      stats.numChildSlots += node.m_children.GetNumSlots();
+      stats.numNullChildSlots += node.m_children.GetNumSlots() - numChildren;
+      if( node.m_isEndOfAnEntry )
+      {
+        ++stats.numEntries;
+        stats.totalKeyLength += cur.keyLength;
+      }
+      if( stats.fanout.size() <= numChildren )
+      {
+        stats.fanout.resize( numChildren + 1ULL );
+      }
+      ++stats.fanout[numChildren];
+      if( stats.depth.size() <= cur.depth )
       {
-        GetAllStringsWithNodes( derived, intialStr, stringsWithNodes );
+        stats.depth.resize( cur.depth + 1ULL );
       }
+      ++stats.depth[cur.depth];
+
+      node.m_children.ForEach( [&pending, &cur]( size_t const, NodePtr const& child )
+      {
+        auto const childNode { static_cast< NodeTy const* >( AllocTy::Raw( child ) ) };
+        pending.push_back( { childNode, cur.depth + 1ULL, cur.keyLength + NodeTy::GetEdgeLength( *childNode ) } );
+      } );
     }
   }
   #pragma endregion
 
   size_t const GetNumChildren() const
   {
-    return m_numChildren;
+    return m_children.Size();
+  }
+
+  CharTy const GetChar() const
+  {
+    return m_char;
+  }
+
+  bool const IsEndOfAnEntry() const
+  {
+    return m_isEndOfAnEntry;
+  }
+
+  // Calls fn( child ) for every child in ascending character order
+  template< typename FnTy >
+  void ForEachChild( FnTy&& fn ) const
+  {
+    m_children.ForEach( [&fn]( size_t const, NodePtr const& child )
+    {
+      fn( child );
+    } );
+  }
+
+  // The first child whose CharIndex is at least charIndex, updating charIndex
+  // to its CharIndex, or nullptr if there is none
+  NodePtr const* GetNextChild( size_t& charIndex ) const
+  {
+    return m_children.Next( charIndex );
+  }
+
+  // Sizes child storage ahead of adding count children to a childless node
+  void ReserveChildren( size_t const count )
+  {
+    m_children.Reserve( count );
+  }
+
+  static size_t const CharIndex( CharTy const c )
+  {
+    return AlphabetTy::Index( c );
+  }
+
+  // Whether every character of [begin, end) is in the alphabet
+  template< typename IterTy >
+  static bool const InAlphabet( IterTy begin, IterTy const& end )
+  {
+    if( AlphabetTy::IsFull )
+    {
+      return true;
+    }
+    for( ; begin != end; ++begin )
+    {
+      if( CharIndex( *begin ) >= NumChars )
+      {
+        return false;
+      }
+    }
+    return true;
   }
 
 protected:
   CharTy m_char;
   bool m_isEndOfAnEntry;
-  size_t m_numChildren;
-  std::vector< std::shared_ptr< TrieNode< CharTy > > > m_children;
-
+  Children m_children;
 
-  std::shared_ptr< TrieNode< CharTy > > const& GetChild( CharTy const c ) const
+  NodePtr const& GetChild( CharTy const c ) const
   {
-    return m_children[c];
+    auto const index { CharIndex( c ) };
+    return ( AlphabetTy::IsFull || index < NumChars ) ? m_children.Get( index ) : Children::Null();
   }
 
   template< typename NodeTy >
   void AddChild( NodeTy const& node )
   {
-    auto const c { node->m_char };
-    m_children[c] = node;
-    ++m_numChildren;
+    m_children.Set( CharIndex( node->m_char ), node );
   }
 
   void RemoveChild( CharTy const c )
   {
-    m_children[c].reset();
-    --m_numChildren;
+    m_children.Remove( CharIndex( c ) );
+  }
+
+  // Marks or unmarks node as the end of an entry, telling the arena when
+  // that changes so counting arenas can track the number of entries
+  template< typename ArenaTy >
+  static void SetEndOfAnEntry( TrieNode& node, bool const isEndOfAnEntry, ArenaTy& arena )
+  {
+    if( node.m_isEndOfAnEntry != isEndOfAnEntry )
+    {
+      node.m_isEndOfAnEntry = isEndOfAnEntry;
+      arena.AddEntries( isEndOfAnEntry ? 1 : -1 );
+    }
   }
 
   #pragma region Private Static Operations
-  template< typename NodeTy >
-  static void GetAllStrings( std::shared_ptr< NodeTy > const& root, std::basic_string< CharTy > strToRoot, std::vector< std::basic_string< CharTy > >& strings )
+  // Fills row with the distances after appending c to a key of length
+  // depth - 1 whose distances are in prevRow, returns the smallest. Only the
+  // band of cells within maxDistance of the diagonal can be in bound, so
+  // only they are computed, with capped cells either side of it.
+  static size_t const NextRow( size_t const* const prevRow, size_t* const row, std::basic_string< CharTy > const& query,
+                               CharTy const c, size_t const depth, size_t const maxDistance )
   {
-    static_assert( std::is_base_of< TrieNode< CharTy >, NodeTy >::value, "Must use a TrieNode type" );
+    size_t const cap { maxDistance + 1ULL };
+    size_t const first { ( depth > maxDistance ) ? depth - maxDistance : 1ULL };
+    auto const last { std::min( query.size(), depth + maxDistance ) };
 
+    row[0] = std::min( depth, cap );
+    row[first - 1ULL] = ( first > 1ULL ) ? cap : row[0];
+    if( last < query.size() )
+    {
+      row[last + 1ULL] = cap;
+    }
+
+    auto minDistance { row[0] };
+    for( auto i { first }; i <= last; ++i )
+    {
+      size_t const substitution { prevRow[i - 1ULL] + ( ( query[i - 1ULL] == c ) ? 0ULL : 1ULL ) };
+      size_t const edit { std::min( prevRow[i], row[i - 1ULL] ) + 1ULL };
+      row[i] = std::min( cap, std::min( substitution, edit ) );
+      minDistance = std::min( minDistance, row[i] );
+    }
+    return minDistance;
+  }
+
+  static void GetAllStrings( NodePtr const& root, std::basic_string< CharTy > strToRoot, std::vector< std::basic_string< CharTy > >& strings )
+  {
     auto strToCurrent { strToRoot + root->m_char };
     if( root->m_isEndOfAnEntry )
     {
       strings.push_back( strToCurrent );
     }
 
-    for( auto const& child : root->m_children )
+    root->m_children.ForEach( [&]( size_t const, NodePtr const& child )
     {
-      if( child != nullptr )
-      {
-        GetAllStrings( child, strToCurrent, strings );
-      }
-    }
+      GetAllStrings( child, strToCurrent, strings );
+    } );
   }
 
-  template< typename NodeTy >
-  static void GetAllStringsWithNodes( std::shared_ptr< NodeTy > const& root,
+  template< typename NodePtrTy >
+  static void GetAllStringsWithNodes( NodePtrTy const& root,
                                       std::basic_string< CharTy > strToRoot,
-                                      std::vector< typename NodeTy::Pair >& stringsWithNodes )
+                                      std::vector< typename NodeOf< NodePtrTy >::Pair >& stringsWithNodes )
   {
-    static_assert(std::is_base_of< TrieNode< CharTy >, NodeTy >::value, "Must use a TrieNode type");
+    typedef NodeOf< NodePtrTy > NodeTy;
 
     auto strToCurrent { strToRoot + root->m_char };
     if( root->m_isEndOfAnEntry )
@@ -285,14 +932,10 @@ protected:
       stringsWithNodes.push_back( { strToCurrent, root } );
     }
 
-    for( auto const& child : root->m_children )
+    root->m_children.ForEach( [&]( size_t const, NodePtr const& child )
     {
-      auto derived { std::static_pointer_cast<NodeTy>(child) };
-      if( derived != nullptr )
-      {
-        GetAllStringsWithNodes( derived, strToCurrent, stringsWithNodes );
-      }
-    }
+      GetAllStringsWithNodes( AllocTy::template Cast< NodeTy >( child ), strToCurrent, stringsWithNodes );
+    } );
   }
   #pragma endregion
 };
\ No newline at end of file
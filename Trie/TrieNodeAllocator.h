@@ -0,0 +1,326 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Node allocator policies. A policy supplies:
+//   Pointer< NodeTy >  - the type used for child links and returned node handles
+//   Arena< NodeTy >    - per-trie storage used to create and destroy nodes
+//   ManualRelease      - whether removed nodes must be handed back to the arena
+//   Cast / Raw         - static downcast and raw pointer access for Pointer
+// An arena's AddEntries( delta ) is called whenever nodes become or stop
+// being the end of an entry.
+
+// Every node is individually reference counted. Handles keep their node alive.
+struct SharedNodeAllocator
+{
+  template< typename NodeTy >
+  using Pointer = std::shared_ptr< NodeTy >;
+
+  static constexpr bool ManualRelease = false;
+
+  template< typename NodeTy, typename BaseTy >
+  static std::shared_ptr< NodeTy > Cast( std::shared_ptr< BaseTy > const& node )
+  {
+    return std::static_pointer_cast< NodeTy >( node );
+  }
+
+  template< typename NodeTy >
+  static NodeTy* Raw( std::shared_ptr< NodeTy > const& node )
+  {
+    return node.get();
+  }
+
+  template< typename NodeTy >
+  class Arena
+  {
+  public:
+    template< typename... ArgTys >
+    std::shared_ptr< NodeTy > Create( ArgTys&&... args )
+    {
+      return std::make_shared< NodeTy >( std::forward< ArgTys >( args )... );
+    }
+
+    void Destroy( std::shared_ptr< NodeTy > const& )
+    {
+
+    }
+
+    void AddEntries( int const )
+    {
+
+    }
+  };
+};
+
+// Nodes live in per-trie slabs and are linked with raw pointers. Handles are
+// non-owning and only valid while the node is in the trie. Destroying the trie
+// releases every slab at once.
+struct ArenaNodeAllocator
+{
+  template< typename NodeTy >
+  using Pointer = NodeTy*;
+
+  static constexpr bool ManualRelease = true;
+
+  template< typename NodeTy, typename BaseTy >
+  static NodeTy* Cast( BaseTy* const node )
+  {
+    return static_cast< NodeTy* >( node );
+  }
+
+  template< typename NodeTy >
+  static NodeTy* Raw( NodeTy* const node )
+  {
+    return node;
+  }
+
+  template< typename NodeTy >
+  class Arena
+  {
+  public:
+    static constexpr size_t NodesPerSlab = 256ULL;
+
+    #pragma region Constructors
+    Arena()
+      : m_slabUsed { NodesPerSlab }
+    {
+
+    }
+
+    Arena( Arena const& ) = delete;
+
+    Arena( Arena&& rhs ) noexcept
+      : Arena()
+    {
+      Swap( rhs );
+    }
+
+    ~Arena()
+    {
+      Reset();
+    }
+    #pragma endregion
+
+    #pragma region Operator Overrides
+    Arena& operator=( Arena const& ) = delete;
+
+    Arena& operator=( Arena&& rhs ) noexcept
+    {
+      if( &rhs != this )
+      {
+        Arena released { std::move( rhs ) };
+        Swap( released );
+      }
+      return *this;
+    }
+    #pragma endregion
+
+    template< typename... ArgTys >
+    NodeTy* Create( ArgTys&&... args )
+    {
+      NodeTy* slot { nullptr };
+      if( !m_free.empty() )
+      {
+        slot = m_free.back();
+        m_free.pop_back();
+      }
+      else
+      {
+        if( m_slabUsed == NodesPerSlab )
+        {
+          m_slabs.emplace_back( new Slot[NodesPerSlab] );
+          m_slabUsed = 0ULL;
+        }
+        slot = reinterpret_cast< NodeTy* >( &m_slabs.back()[m_slabUsed++] );
+      }
+
+      try
+      {
+        return new( slot ) NodeTy( std::forward< ArgTys >( args )... );
+      }
+      catch( ... )
+      {
+        m_free.push_back( slot );
+        throw;
+      }
+    }
+
+    void Destroy( NodeTy* const node )
+    {
+      node->~NodeTy();
+      m_free.push_back( node );
+    }
+
+    void AddEntries( int const )
+    {
+
+    }
+
+    // Destroys every node and frees all slabs. This is not O(1): every live
+    // node's destructor runs, freeing the child storage each node keeps on
+    // the heap, and slots on the free list are skipped by sorting it once and
+    // searching it for each slot, O(n + f log f) for n slots and f free ones.
+    void Reset()
+    {
+      if( !std::is_trivially_destructible< NodeTy >::value && !m_slabs.empty() )
+      {
+        std::sort( m_free.begin(), m_free.end(), std::less< NodeTy* >() );
+        for( size_t i { 0ULL }; i < m_slabs.size(); ++i )
+        {
+          auto const used { ( i + 1ULL == m_slabs.size() ) ? m_slabUsed : NodesPerSlab };
+          for( size_t j { 0ULL }; j < used; ++j )
+          {
+            auto const node { reinterpret_cast< NodeTy* >( &m_slabs[i][j] ) };
+            if( m_free.empty() || !std::binary_search( m_free.begin(), m_free.end(), node, std::less< NodeTy* >() ) )
+            {
+              node->~NodeTy();
+            }
+          }
+        }
+      }
+
+      m_slabs.clear();
+      m_free.clear();
+      m_slabUsed = NodesPerSlab;
+    }
+
+    size_t const GetNumNodes() const
+    {
+      auto const allocated { m_slabs.empty() ? 0ULL : ( m_slabs.size() - 1ULL ) * NodesPerSlab + m_slabUsed };
+      return allocated - m_free.size();
+    }
+
+  private:
+    typedef typename std::aligned_storage< sizeof( NodeTy ), alignof( NodeTy ) >::type Slot;
+
+    std::vector< std::unique_ptr< Slot[] > > m_slabs;
+    size_t m_slabUsed;
+    std::vector< NodeTy* > m_free;
+
+    void Swap( Arena& rhs ) noexcept
+    {
+      m_slabs.swap( rhs.m_slabs );
+      std::swap( m_slabUsed, rhs.m_slabUsed );
+      m_free.swap( rhs.m_free );
+    }
+  };
+};
+
+// BaseAllocTy, keeping count of the nodes and entries in each trie as it
+// changes so they can be read at any time without walking it. Removed nodes
+// are handed back to the arena to be counted, even for shared nodes.
+template< typename BaseAllocTy = SharedNodeAllocator >
+struct CountingNodeAllocator
+{
+  template< typename NodeTy >
+  using Pointer = typename BaseAllocTy::template Pointer< NodeTy >;
+
+  static constexpr bool ManualRelease = true;
+
+  template< typename NodeTy, typename PtrTy >
+  static Pointer< NodeTy > Cast( PtrTy const& node )
+  {
+    return BaseAllocTy::template Cast< NodeTy >( node );
+  }
+
+  template< typename PtrTy >
+  static auto Raw( PtrTy const& node )
+  {
+    return BaseAllocTy::Raw( node );
+  }
+
+  template< typename NodeTy >
+  class Arena
+  {
+  public:
+    #pragma region Constructors
+    Arena()
+      : m_numNodes { 0ULL }, m_numEntries { 0ULL }
+    {
+
+    }
+
+    Arena( Arena const& ) = delete;
+
+    Arena( Arena&& rhs ) noexcept
+      : m_arena { std::move( rhs.m_arena ) }, m_numNodes { rhs.m_numNodes }, m_numEntries { rhs.m_numEntries }
+    {
+      rhs.m_numNodes = 0ULL;
+      rhs.m_numEntries = 0ULL;
+    }
+    #pragma endregion
+
+    #pragma region Operator Overrides
+    Arena& operator=( Arena const& ) = delete;
+
+    Arena& operator=( Arena&& rhs ) noexcept
+    {
+      if( &rhs != this )
+      {
+        m_arena = std::move( rhs.m_arena );
+        m_numNodes = rhs.m_numNodes;
+        m_numEntries = rhs.m_numEntries;
+        rhs.m_numNodes = 0ULL;
+        rhs.m_numEntries = 0ULL;
+      }
+      return *this;
+    }
+    #pragma endregion
+
+    template< typename... ArgTys >
+    Pointer< NodeTy > Create( ArgTys&&... args )
+    {
+      auto node { m_arena.Create( std::forward< ArgTys >( args )... ) };
+      ++m_numNodes;
+      return node;
+    }
+
+    void Destroy( Pointer< NodeTy > const& node )
+    {
+      m_arena.Destroy( node );
+      --m_numNodes;
+    }
+
+    void AddEntries( int const delta )
+    {
+      m_numEntries += static_cast< size_t >( static_cast< std::ptrdiff_t >( delta ) );
+    }
+
+    size_t const GetNumNodes() const
+    {
+      return m_numNodes;
+    }
+
+    size_t const GetNumEntries() const
+    {
+      return m_numEntries;
+    }
+
+  private:
+    typename BaseAllocTy::template Arena< NodeTy > m_arena;
+    size_t m_numNodes;
+    size_t m_numEntries;
+  };
+};
@@ -0,0 +1,472 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define TRIE_PREFETCH( address ) __builtin_prefetch( address )
+#else
+#define TRIE_PREFETCH( address ) static_cast< void >( address )
+#endif
+
+// Child links of a TrieNode, keyed by a character index in [0, NumSlots).
+// The layout adapts to the number of children:
+//   Small   - a few sorted keys, linear search
+//   Indexed - byte fanouts use a key -> slot table, wider fanouts binary search sorted keys
+//   Direct  - one slot per key, only used once a node is dense
+template< typename PtrTy, size_t NumSlots >
+class TrieNodeChildren
+{
+public:
+  typedef typename std::conditional< ( NumSlots <= ( 1ULL << 8 ) ), uint8_t,
+          typename std::conditional< ( NumSlots <= ( 1ULL << 16 ) ), uint16_t,
+          typename std::conditional< ( NumSlots <= ( 1ULL << 32 ) ), uint32_t, uint64_t >::type >::type >::type KeyTy;
+
+  enum class Kind : uint8_t
+  {
+    Small,
+    Indexed,
+    Direct
+  };
+
+  static constexpr size_t SmallCapacity = 4ULL;
+  static constexpr bool HasByteIndex = NumSlots <= ( 1ULL << 8 );
+  static constexpr bool AlwaysDirect = NumSlots <= 16ULL;
+  static constexpr size_t IndexedCapacity = HasByteIndex ? 48ULL
+                                          : ( NumSlots <= ( 1ULL << 16 ) ) ? NumSlots / 8ULL
+                                          : std::numeric_limits< size_t >::max();
+
+  #pragma region Constructors
+  TrieNodeChildren()
+    : m_kind { InitialKind() }, m_size { 0ULL }
+  {
+
+  }
+  #pragma endregion
+
+  #pragma region Getters
+  size_t const Size() const
+  {
+    return m_size;
+  }
+
+  bool const Empty() const
+  {
+    return m_size == 0ULL;
+  }
+
+  Kind const GetKind() const
+  {
+    return m_kind;
+  }
+
+  // Child links allocated, used or not
+  size_t const GetNumSlots() const
+  {
+    return m_nodes.capacity();
+  }
+
+  // Bytes of storage allocated for the children
+  size_t const GetHeapBytes() const
+  {
+    return m_keys.capacity() * sizeof( KeyTy ) + m_index.capacity() * sizeof( uint8_t ) + m_nodes.capacity() * sizeof( PtrTy );
+  }
+
+  // The empty link Get returns for a missing child
+  static PtrTy const& Null()
+  {
+    static PtrTy const null {};
+    return null;
+  }
+
+  PtrTy const& Get( size_t const key ) const
+  {
+    switch( m_kind )
+    {
+      case Kind::Small:
+      {
+        for( size_t i { 0ULL }; i < m_size && m_keys[i] <= key; ++i )
+        {
+          if( m_keys[i] == key )
+          {
+            return m_nodes[i];
+          }
+        }
+        return Null();
+      }
+      case Kind::Indexed:
+      {
+        if( HasByteIndex )
+        {
+          auto const slot { m_index[key] };
+          return ( slot == 0 ) ? Null() : m_nodes[slot - 1];
+        }
+
+        auto const pos { SortedPosition( key ) };
+        return ( pos < m_size && m_keys[pos] == key ) ? m_nodes[pos] : Null();
+      }
+      case Kind::Direct:
+      default:
+        return m_nodes.empty() ? Null() : m_nodes[key];
+    }
+  }
+
+  // The first child whose key is at least key, updating key to its key, or
+  // nullptr if there is none
+  PtrTy const* Next( size_t& key ) const
+  {
+    if( m_size == 0ULL )
+    {
+      return nullptr;
+    }
+
+    if( m_kind == Kind::Small || ( m_kind == Kind::Indexed && !HasByteIndex ) )
+    {
+      auto const pos { SortedPosition( key ) };
+      if( pos == m_size )
+      {
+        return nullptr;
+      }
+      key = static_cast< size_t >( m_keys[pos] );
+      return &m_nodes[pos];
+    }
+    else if( m_kind == Kind::Indexed )
+    {
+      for( ; key < NumSlots; ++key )
+      {
+        auto const slot { m_index[key] };
+        if( slot != 0 )
+        {
+          return &m_nodes[slot - 1];
+        }
+      }
+    }
+    else
+    {
+      for( ; key < NumSlots; ++key )
+      {
+        if( m_nodes[key] != nullptr )
+        {
+          return &m_nodes[key];
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  // Asks the cache to start loading what Get( key ) reads, never faults
+  void Prefetch( size_t const key ) const
+  {
+    switch( m_kind )
+    {
+      case Kind::Small:
+        TRIE_PREFETCH( m_keys.data() );
+        TRIE_PREFETCH( m_nodes.data() );
+        break;
+      case Kind::Indexed:
+        TRIE_PREFETCH( HasByteIndex ? static_cast< void const* >( m_index.data() + key ) : m_keys.data() );
+        TRIE_PREFETCH( m_nodes.data() );
+        break;
+      case Kind::Direct:
+      default:
+        TRIE_PREFETCH( m_nodes.data() + ( m_nodes.empty() ? 0ULL : key ) );
+        break;
+    }
+  }
+
+  // Calls fn( key, node ) for every child in ascending key order
+  template< typename FnTy >
+  void ForEach( FnTy&& fn ) const
+  {
+    if( m_size == 0ULL )
+    {
+      return;
+    }
+
+    if( m_kind == Kind::Small || ( m_kind == Kind::Indexed && !HasByteIndex ) )
+    {
+      for( size_t i { 0ULL }; i < m_size; ++i )
+      {
+        fn( static_cast< size_t >( m_keys[i] ), m_nodes[i] );
+      }
+    }
+    else if( m_kind == Kind::Indexed )
+    {
+      for( size_t key { 0ULL }; key < NumSlots; ++key )
+      {
+        auto const slot { m_index[key] };
+        if( slot != 0 )
+        {
+          fn( key, m_nodes[slot - 1] );
+        }
+      }
+    }
+    else
+    {
+      for( size_t key { 0ULL }; key < NumSlots; ++key )
+      {
+        if( m_nodes[key] != nullptr )
+        {
+          fn( key, m_nodes[key] );
+        }
+      }
+    }
+  }
+  #pragma endregion
+
+  #pragma region Modifiers
+  // Adds the child at key, replacing any existing child
+  void Set( size_t const key, PtrTy node )
+  {
+    switch( m_kind )
+    {
+      case Kind::Small:
+      case Kind::Indexed:
+      {
+        if( m_kind == Kind::Indexed && HasByteIndex )
+        {
+          auto const slot { m_index[key] };
+          if( slot != 0 )
+          {
+            m_nodes[slot - 1] = std::move( node );
+            return;
+          }
+          if( m_size < IndexedCapacity )
+          {
+            m_index[key] = static_cast< uint8_t >( m_size + 1ULL );
+            m_keys.push_back( static_cast< KeyTy >( key ) );
+            m_nodes.push_back( std::move( node ) );
+            ++m_size;
+            return;
+          }
+        }
+        else
+        {
+          auto const pos { SortedPosition( key ) };
+          if( pos < m_size && m_keys[pos] == key )
+          {
+            m_nodes[pos] = std::move( node );
+            return;
+          }
+          if( m_size < Capacity( m_kind ) )
+          {
+            m_keys.insert( m_keys.begin() + pos, static_cast< KeyTy >( key ) );
+            m_nodes.insert( m_nodes.begin() + pos, std::move( node ) );
+            ++m_size;
+            return;
+          }
+        }
+
+        Rebuild( m_kind == Kind::Small ? GrowKind() : Kind::Direct );
+        Set( key, std::move( node ) );
+        return;
+      }
+      case Kind::Direct:
+      default:
+      {
+        if( m_nodes.empty() )
+        {
+          m_nodes.resize( NumSlots );
+        }
+        if( m_nodes[key] == nullptr )
+        {
+          ++m_size;
+        }
+        m_nodes[key] = std::move( node );
+        return;
+      }
+    }
+  }
+
+  void Remove( size_t const key )
+  {
+    switch( m_kind )
+    {
+      case Kind::Small:
+      case Kind::Indexed:
+      {
+        if( m_kind == Kind::Indexed && HasByteIndex )
+        {
+          auto const slot { m_index[key] };
+          if( slot == 0 )
+          {
+            return;
+          }
+
+          auto const pos { slot - 1ULL };
+          auto const lastPos { m_size - 1ULL };
+          if( pos != lastPos )
+          {
+            m_keys[pos] = m_keys[lastPos];
+            m_nodes[pos] = std::move( m_nodes[lastPos] );
+            m_index[m_keys[pos]] = static_cast< uint8_t >( slot );
+          }
+          m_keys.pop_back();
+          m_nodes.pop_back();
+          m_index[key] = 0;
+        }
+        else
+        {
+          auto const pos { SortedPosition( key ) };
+          if( pos >= m_size || m_keys[pos] != key )
+          {
+            return;
+          }
+          m_keys.erase( m_keys.begin() + pos );
+          m_nodes.erase( m_nodes.begin() + pos );
+        }
+        --m_size;
+        break;
+      }
+      case Kind::Direct:
+      default:
+      {
+        if( m_nodes.empty() || m_nodes[key] == nullptr )
+        {
+          return;
+        }
+        m_nodes[key] = nullptr;
+        --m_size;
+        break;
+      }
+    }
+
+    if( m_size == 0ULL )
+    {
+      Clear();
+    }
+    else if( m_size <= Capacity( ShrinkKind() ) / 2ULL )
+    {
+      Rebuild( ShrinkKind() );
+    }
+  }
+
+  // Sizes empty storage for count children so adding them never regrows it
+  void Reserve( size_t const count )
+  {
+    if( m_size != 0ULL || count == 0ULL )
+    {
+      return;
+    }
+
+    m_kind = ( count <= Capacity( InitialKind() ) ) ? InitialKind()
+           : ( count <= Capacity( GrowKind() ) ) ? GrowKind()
+           : Kind::Direct;
+    if( m_kind == Kind::Indexed && HasByteIndex )
+    {
+      m_index.resize( NumSlots );
+    }
+    if( m_kind == Kind::Direct )
+    {
+      m_nodes.resize( NumSlots );
+    }
+    else
+    {
+      m_keys.reserve( count );
+      m_nodes.reserve( count );
+    }
+  }
+
+  void Clear()
+  {
+    std::vector< KeyTy >().swap( m_keys );
+    std::vector< uint8_t >().swap( m_index );
+    std::vector< PtrTy >().swap( m_nodes );
+    m_kind = InitialKind();
+    m_size = 0ULL;
+  }
+  #pragma endregion
+
+private:
+  Kind m_kind;
+  size_t m_size;
+  std::vector< KeyTy > m_keys;
+  std::vector< uint8_t > m_index;
+  std::vector< PtrTy > m_nodes;
+
+  static constexpr Kind InitialKind()
+  {
+    return AlwaysDirect ? Kind::Direct : Kind::Small;
+  }
+
+  static constexpr Kind GrowKind()
+  {
+    return ( IndexedCapacity > SmallCapacity ) ? Kind::Indexed : Kind::Direct;
+  }
+
+  Kind const ShrinkKind() const
+  {
+    if( m_kind == Kind::Direct && !AlwaysDirect )
+    {
+      return GrowKind();
+    }
+    return ( m_kind == Kind::Indexed ) ? Kind::Small : m_kind;
+  }
+
+  static constexpr size_t Capacity( Kind const kind )
+  {
+    return ( kind == Kind::Small ) ? SmallCapacity
+         : ( kind == Kind::Indexed ) ? IndexedCapacity
+         : NumSlots;
+  }
+
+  size_t const SortedPosition( size_t const key ) const
+  {
+    auto const it { std::lower_bound( m_keys.begin(), m_keys.begin() + m_size, key, []( KeyTy const lhs, size_t const rhs )
+    {
+      return lhs < rhs;
+    } ) };
+    return static_cast< size_t >( it - m_keys.begin() );
+  }
+
+  void Rebuild( Kind const kind )
+  {
+    if( kind == m_kind )
+    {
+      return;
+    }
+
+    std::vector< std::pair< size_t, PtrTy > > children;
+    children.reserve( m_size );
+    ForEach( [&children]( size_t const key, PtrTy const& node )
+    {
+      children.emplace_back( key, node );
+    } );
+
+    Clear();
+    m_kind = kind;
+    if( kind == Kind::Indexed && HasByteIndex )
+    {
+      m_index.resize( NumSlots );
+    }
+    if( kind != Kind::Direct )
+    {
+      m_keys.reserve( children.size() );
+      m_nodes.reserve( children.size() );
+    }
+
+    for( auto& child : children )
+    {
+      Set( child.first, std::move( child.second ) );
+    }
+  }
+};
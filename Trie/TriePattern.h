@@ -0,0 +1,204 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Glob style pattern matched one character at a time as a set of positions:
+//   ?       any single character
+//   *       any run of characters, including none
+//   [a-z0]  one character from the class, [!...] or [^...] negates it
+//   \c      the character c
+// Any other character, and a [ without a closing ], matches itself.
+template< typename CharTy >
+class TriePattern
+{
+public:
+  enum class Kind : uint8_t
+  {
+    Literal,
+    Any,
+    Star,
+    Class
+  };
+
+  struct Token
+  {
+    Kind kind;
+    CharTy literal;
+    bool negated;
+    std::vector< std::pair< size_t, size_t > > ranges;
+  };
+
+  #pragma region Constructors
+  explicit TriePattern( std::basic_string< CharTy > const& pattern )
+  {
+    for( size_t i { 0ULL }; i < pattern.size(); ++i )
+    {
+      auto const c { pattern[i] };
+      if( c == static_cast< CharTy >( '*' ) )
+      {
+        if( m_tokens.empty() || m_tokens.back().kind != Kind::Star )
+        {
+          m_tokens.push_back( { Kind::Star, c, false, {} } );
+        }
+      }
+      else if( c == static_cast< CharTy >( '?' ) )
+      {
+        m_tokens.push_back( { Kind::Any, c, false, {} } );
+      }
+      else if( c == static_cast< CharTy >( '[' ) && ParseClass( pattern, i ) )
+      {
+        continue;
+      }
+      else
+      {
+        if( c == static_cast< CharTy >( '\\' ) && i + 1ULL < pattern.size() )
+        {
+          ++i;
+        }
+        m_tokens.push_back( { Kind::Literal, pattern[i], false, {} } );
+      }
+    }
+  }
+  #pragma endregion
+
+  size_t const GetNumTokens() const
+  {
+    return m_tokens.size();
+  }
+
+  Token const& GetToken( size_t const pos ) const
+  {
+    return m_tokens[pos];
+  }
+
+  bool const Matches( size_t const pos, CharTy const c ) const
+  {
+    auto const& token { m_tokens[pos] };
+    switch( token.kind )
+    {
+      case Kind::Literal:
+        return token.literal == c;
+      case Kind::Class:
+      {
+        auto const index { CharIndex( c ) };
+        auto const inClass { std::any_of( token.ranges.begin(), token.ranges.end(), [index]( std::pair< size_t, size_t > const& range )
+        {
+          return range.first <= index && index <= range.second;
+        } ) };
+        return inClass != token.negated;
+      }
+      case Kind::Any:
+      case Kind::Star:
+      default:
+        return true;
+    }
+  }
+
+  // The positions before any character is read
+  void Start( std::vector< size_t >& positions ) const
+  {
+    positions.clear();
+    AddPosition( 0ULL, positions );
+  }
+
+  // The positions after reading c from any of positions, sorted and unique.
+  // A star keeps its position, every other token which matches c moves past
+  // itself, and reaching a star also reaches the positions after it.
+  void Step( std::vector< size_t > const& positions, CharTy const c, std::vector< size_t >& next ) const
+  {
+    next.clear();
+    for( auto const pos : positions )
+    {
+      if( pos == m_tokens.size() )
+      {
+        continue;
+      }
+      if( m_tokens[pos].kind == Kind::Star )
+      {
+        AddPosition( pos, next );
+      }
+      else if( Matches( pos, c ) )
+      {
+        AddPosition( pos + 1ULL, next );
+      }
+    }
+    std::sort( next.begin(), next.end() );
+    next.erase( std::unique( next.begin(), next.end() ), next.end() );
+  }
+
+  // Whether the characters read so far match the whole pattern
+  bool const IsAccepting( std::vector< size_t > const& positions ) const
+  {
+    return !positions.empty() && positions.back() == m_tokens.size();
+  }
+
+  static size_t const CharIndex( CharTy const c )
+  {
+    return static_cast< size_t >( static_cast< typename std::make_unsigned< CharTy >::type >( c ) );
+  }
+
+private:
+  std::vector< Token > m_tokens;
+
+  void AddPosition( size_t pos, std::vector< size_t >& positions ) const
+  {
+    positions.push_back( pos );
+    while( pos < m_tokens.size() && m_tokens[pos].kind == Kind::Star )
+    {
+      positions.push_back( ++pos );
+    }
+  }
+
+  // Parses the class opening at pattern[i], leaving i on its closing ]
+  bool const ParseClass( std::basic_string< CharTy > const& pattern, size_t& i )
+  {
+    Token token { Kind::Class, pattern[i], false, {} };
+    auto pos { i + 1ULL };
+    if( pos < pattern.size() && ( pattern[pos] == static_cast< CharTy >( '!' ) || pattern[pos] == static_cast< CharTy >( '^' ) ) )
+    {
+      token.negated = true;
+      ++pos;
+    }
+
+    // a ] straight after the opening is part of the class
+    for( auto first { pos }; pos < pattern.size() && ( pos == first || pattern[pos] != static_cast< CharTy >( ']' ) ); ++pos )
+    {
+      auto const lo { CharIndex( pattern[pos] ) };
+      auto hi { lo };
+      if( pos + 2ULL < pattern.size() && pattern[pos + 1ULL] == static_cast< CharTy >( '-' ) && pattern[pos + 2ULL] != static_cast< CharTy >( ']' ) )
+      {
+        pos += 2ULL;
+        hi = CharIndex( pattern[pos] );
+      }
+      token.ranges.push_back( { std::min( lo, hi ), std::max( lo, hi ) } );
+    }
+
+    if( pos >= pattern.size() )
+    {
+      return false;
+    }
+    i = pos;
+    m_tokens.push_back( std::move( token ) );
+    return true;
+  }
+};
@@ -0,0 +1,53 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Shape and memory of a trie, see BasicTrie::GetStats. Byte counts cover
+// the nodes and what they allocate, not the allocator's own bookkeeping
+// such as shared_ptr control blocks or unused arena slots.
+struct TrieStats
+{
+  size_t numNodes;
+  size_t numEntries;
+  // node objects without their payloads, plus edge labels stored outside them
+  size_t nodeBytes;
+  // child link storage allocated by nodes
+  size_t childBytes;
+  // DataTy payloads, which every node holds whether or not it is an entry
+  size_t dataBytes;
+  // child links allocated, and how many of them hold no child
+  size_t numChildSlots;
+  size_t numNullChildSlots;
+  // sum of the lengths of every entry
+  size_t totalKeyLength;
+  // fanout[n] is the number of nodes with n children
+  std::vector< size_t > fanout;
+  // depth[d] is the number of nodes d links below the root
+  std::vector< size_t > depth;
+
+  size_t const GetTotalBytes() const
+  {
+    return nodeBytes + childBytes + dataBytes;
+  }
+
+  double const GetAverageKeyLength() const
+  {
+    return ( numEntries == 0ULL ) ? 0.0 : static_cast< double >( totalKeyLength ) / static_cast< double >( numEntries );
+  }
+};
@@ -0,0 +1,224 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Trie.h"
+#include "DataTrie.h"
+
+// Converts wide keys to and from UTF-8. char16_t keys (and a two byte
+// wchar_t) are read as UTF-16, any other type as one code point per
+// character. Code points above U+10FFFF and unpaired surrogates are encoded
+// the same way as any other value, with up to seven bytes, so every key
+// round trips. Byte order is code point order.
+template< typename CharTy >
+class Utf8Codec
+{
+public:
+  static constexpr bool IsUtf16 = sizeof( CharTy ) == 2ULL;
+
+  static void Encode( std::basic_string< CharTy > const& str, std::basic_string< char >& bytes )
+  {
+    bytes.clear();
+    for( size_t i { 0ULL }; i < str.size(); ++i )
+    {
+      auto codePoint { CodeUnit( str[i] ) };
+      if( IsUtf16 && IsHighSurrogate( codePoint ) && i + 1ULL < str.size() && IsLowSurrogate( CodeUnit( str[i + 1ULL] ) ) )
+      {
+        codePoint = 0x10000U + ( ( codePoint - 0xD800U ) << 10 ) + ( CodeUnit( str[++i] ) - 0xDC00U );
+      }
+      AppendCodePoint( codePoint, bytes );
+    }
+  }
+
+  static std::basic_string< char > const Encode( std::basic_string< CharTy > const& str )
+  {
+    std::basic_string< char > bytes;
+    Encode( str, bytes );
+    return bytes;
+  }
+
+  static void Decode( std::basic_string< char > const& bytes, std::basic_string< CharTy >& str )
+  {
+    str.clear();
+    for( size_t i { 0ULL }; i < bytes.size(); )
+    {
+      auto const lead { static_cast< uint8_t >( bytes[i++] ) };
+      size_t numTrailing { 0ULL };
+      while( numTrailing < 6ULL && ( lead & ( 0x40U >> numTrailing ) ) != 0U && ( lead & 0x80U ) != 0U )
+      {
+        ++numTrailing;
+      }
+      auto codePoint { static_cast< uint32_t >( lead & ( 0x7FU >> numTrailing ) ) };
+      for( ; numTrailing > 0ULL && i < bytes.size(); --numTrailing )
+      {
+        codePoint = ( codePoint << 6 ) | ( static_cast< uint8_t >( bytes[i++] ) & 0x3FU );
+      }
+
+      if( IsUtf16 && codePoint >= 0x10000U )
+      {
+        codePoint -= 0x10000U;
+        str.push_back( static_cast< CharTy >( 0xD800U + ( codePoint >> 10 ) ) );
+        str.push_back( static_cast< CharTy >( 0xDC00U + ( codePoint & 0x3FFU ) ) );
+      }
+      else
+      {
+        str.push_back( static_cast< CharTy >( codePoint ) );
+      }
+    }
+  }
+
+  static std::basic_string< CharTy > const Decode( std::basic_string< char > const& bytes )
+  {
+    std::basic_string< CharTy > str;
+    Decode( bytes, str );
+    return str;
+  }
+
+private:
+  static uint32_t const CodeUnit( CharTy const c )
+  {
+    return static_cast< uint32_t >( static_cast< typename std::make_unsigned< CharTy >::type >( c ) );
+  }
+
+  static bool const IsHighSurrogate( uint32_t const unit )
+  {
+    return unit >= 0xD800U && unit <= 0xDBFFU;
+  }
+
+  static bool const IsLowSurrogate( uint32_t const unit )
+  {
+    return unit >= 0xDC00U && unit <= 0xDFFFU;
+  }
+
+  // Lead byte of n bytes is n ones then a zero, followed by the top bits of
+  // the code point, the rest go six to a continuation byte
+  static void AppendCodePoint( uint32_t const codePoint, std::basic_string< char >& bytes )
+  {
+    if( codePoint < 0x80U )
+    {
+      bytes.push_back( static_cast< char >( codePoint ) );
+      return;
+    }
+
+    size_t numTrailing { 1ULL };
+    while( numTrailing < 6ULL && ( static_cast< uint64_t >( codePoint ) >> ( 6ULL * numTrailing ) ) >= ( 0x40ULL >> numTrailing ) )
+    {
+      ++numTrailing;
+    }
+    auto const leadMarker { static_cast< uint32_t >( ( 0xFF00U >> ( numTrailing + 1ULL ) ) & 0xFFU ) };
+    bytes.push_back( static_cast< char >( leadMarker | static_cast< uint32_t >( static_cast< uint64_t >( codePoint ) >> ( 6ULL * numTrailing ) ) ) );
+    for( auto shift { numTrailing }; shift > 0ULL; --shift )
+    {
+      bytes.push_back( static_cast< char >( 0x80U | ( ( codePoint >> ( 6ULL * ( shift - 1ULL ) ) ) & 0x3FU ) ) );
+    }
+  }
+};
+
+// Wide character trie stored as UTF-8 over byte nodes. Keys are encoded on
+// the way in and decoded on the way out, so nodes have at most 256 children
+// and can use the compact byte indexed child layouts. Entries are
+// enumerated in code point order. ByteTrieTy is Trie< char > or
+// DataTrie< char, DataTy >, whose nodes are returned by Find and Insert.
+template< typename ByteTrieTy, typename CharTy >
+class BasicUtf8Trie
+{
+public:
+  typedef Utf8Codec< CharTy > Codec;
+  typedef typename ByteTrieTy::NodePtr NodePtr;
+  typedef std::pair< std::basic_string< CharTy >, NodePtr > Pair;
+
+  NodePtr const Insert( std::basic_string< CharTy > const& str )
+  {
+    return m_trie.Insert( Codec::Encode( str ) );
+  }
+
+  NodePtr const Remove( std::basic_string< CharTy > const& str )
+  {
+    return m_trie.Remove( Codec::Encode( str ) );
+  }
+
+  NodePtr const Find( std::basic_string< CharTy > const& str ) const
+  {
+    return m_trie.Find( Codec::Encode( str ) );
+  }
+
+  bool const HasString( std::basic_string< CharTy > const& str ) const
+  {
+    return m_trie.HasString( Codec::Encode( str ) );
+  }
+
+  void GetAllStrings( std::vector< std::basic_string< CharTy > >& strings ) const
+  {
+    for( auto const& bytes : m_trie.GetAllStrings() )
+    {
+      strings.push_back( Codec::Decode( bytes ) );
+    }
+  }
+
+  std::vector< std::basic_string< CharTy > > const GetAllStrings() const
+  {
+    std::vector< std::basic_string< CharTy > > strings;
+    GetAllStrings( strings );
+    return strings;
+  }
+
+  void GetAllStringsWithNodes( std::vector< Pair >& stringsWithNodes ) const
+  {
+    for( auto const& pair : m_trie.GetAllStringsWithNodes() )
+    {
+      stringsWithNodes.push_back( { Codec::Decode( pair.first ), pair.second } );
+    }
+  }
+
+  std::vector< Pair > const GetAllStringsWithNodes() const
+  {
+    std::vector< Pair > stringsWithNodes;
+    GetAllStringsWithNodes( stringsWithNodes );
+    return stringsWithNodes;
+  }
+
+  // The underlying byte trie, whose keys are the UTF-8 encodings
+  ByteTrieTy const& GetByteTrie() const
+  {
+    return m_trie;
+  }
+
+protected:
+  ByteTrieTy m_trie;
+};
+
+template< typename CharTy, typename AllocTy = SharedNodeAllocator >
+class Utf8Trie : public BasicUtf8Trie< Trie< char, AllocTy >, CharTy >
+{
+
+};
+
+template< typename CharTy, typename DataTy, typename AllocTy = SharedNodeAllocator >
+class Utf8DataTrie : public BasicUtf8Trie< DataTrie< char, DataTy, AllocTy >, CharTy >
+{
+public:
+  typedef typename BasicUtf8Trie< DataTrie< char, DataTy, AllocTy >, CharTy >::NodePtr NodePtr;
+  using BasicUtf8Trie< DataTrie< char, DataTy, AllocTy >, CharTy >::Insert;
+
+  NodePtr const Insert( std::basic_string< CharTy > const& str, DataTy data )
+  {
+    return this->m_trie.Insert( Utf8Codec< CharTy >::Encode( str ), std::move( data ) );
+  }
+};
@@ -0,0 +1,715 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifdef COMPILE_TRIE_BENCHMARKS
+#include "Trie/Trie.h"
+#include "Trie/DataTrie.h"
+#include "Trie/DoubleArrayTrie.h"
+#include "Trie/ConcurrentTrie.h"
+#include "Trie/RankedDataTrie.h"
+#include "Trie/CountedTrie.h"
+#include "Trie/Utf8Trie.h"
+#include "Trie/StaticTrie.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#if defined( __GLIBC__ )
+#include <malloc.h>
+#endif
+
+#pragma region Data Sets
+static std::vector< std::basic_string< char > > const RandomWords( size_t const count, size_t const seed )
+{
+  std::mt19937_64 rng { seed };
+  std::uniform_int_distribution< size_t > length { 3ULL, 12ULL };
+  std::uniform_int_distribution< int > letter { 'a', 'z' };
+
+  std::vector< std::basic_string< char > > words;
+  words.reserve( count );
+  for( size_t i { 0ULL }; i < count; ++i )
+  {
+    std::basic_string< char > word( length( rng ), ' ' );
+    for( auto& c : word )
+    {
+      c = static_cast< char >( letter( rng ) );
+    }
+    words.push_back( std::move( word ) );
+  }
+  return words;
+}
+#pragma endregion
+
+#pragma region Helpers
+// Runs fn over every key and reports nanoseconds per key
+template< typename FnTy >
+static double const TimePerKey( std::vector< std::basic_string< char > > const& keys, FnTy&& fn )
+{
+  size_t found { 0ULL };
+  auto const start { std::chrono::steady_clock::now() };
+  for( auto const& key : keys )
+  {
+    found += fn( key ) ? 1ULL : 0ULL;
+  }
+  auto const stop { std::chrono::steady_clock::now() };
+
+  // keep the lookups observable
+  if( found == std::numeric_limits< size_t >::max() )
+  {
+    std::cout << found;
+  }
+
+  return std::chrono::duration< double, std::nano >( stop - start ).count() / static_cast< double >( keys.size() );
+}
+
+static void Report( std::basic_string< char > const& name, size_t const numKeys, double const nsPerKey )
+{
+  std::cout << std::left << std::setw( 40 ) << name
+            << std::right << std::setw( 10 ) << numKeys
+            << std::setw( 12 ) << std::fixed << std::setprecision( 1 ) << nsPerKey << " ns/key\n";
+}
+static void ReportBytes( std::basic_string< char > const& name, size_t const numKeys, size_t const numBytes )
+{
+  std::cout << std::left << std::setw( 40 ) << name
+            << std::right << std::setw( 10 ) << numKeys
+            << std::setw( 12 ) << std::fixed << std::setprecision( 1 ) << static_cast< double >( numBytes ) / static_cast< double >( numKeys ) << " bytes/key\n";
+}
+
+// Bytes currently allocated from the heap, or 0 where that is not known
+static size_t const HeapBytes()
+{
+#if defined( __GLIBC__ ) && ( __GLIBC__ > 2 || ( __GLIBC__ == 2 && __GLIBC_MINOR__ >= 33 ) )
+  return mallinfo2().uordblks;
+#else
+  return 0ULL;
+#endif
+}
+
+static void ReportThroughput( std::basic_string< char > const& name, size_t const numThreads, double const opsPerSecond )
+{
+  std::cout << std::left << std::setw( 40 ) << name
+            << std::right << std::setw( 10 ) << numThreads
+            << std::setw( 12 ) << std::fixed << std::setprecision( 2 ) << opsPerSecond / 1e6 << " Mops/s\n";
+}
+
+// Runs fn( thread, op ) numOps times on each of numThreads threads and reports total operations per second
+template< typename FnTy >
+static double const OpsPerSecond( size_t const numThreads, size_t const numOps, FnTy&& fn )
+{
+  std::vector< std::thread > threads;
+  auto const start { std::chrono::steady_clock::now() };
+  for( size_t t { 0ULL }; t < numThreads; ++t )
+  {
+    threads.emplace_back( [&fn, t, numOps]()
+    {
+      for( size_t op { 0ULL }; op < numOps; ++op )
+      {
+        fn( t, op );
+      }
+    } );
+  }
+  for( auto& thread : threads )
+  {
+    thread.join();
+  }
+  auto const stop { std::chrono::steady_clock::now() };
+
+  return static_cast< double >( numThreads * numOps ) / std::chrono::duration< double >( stop - start ).count();
+}
+#pragma endregion
+
+#pragma region Benchmarks
+template< typename TrieTy >
+static void BenchmarkDoubleArrayFind( std::basic_string< char > const& trieName, size_t const numKeys )
+{
+  auto const keys { RandomWords( numKeys, 1ULL ) };
+  auto const misses { RandomWords( numKeys, 2ULL ) };
+
+  TrieTy trie;
+  for( auto const& key : keys )
+  {
+    trie.Insert( key );
+  }
+  DoubleArrayTrie< char > const doubleArray { trie };
+
+  Report( trieName + "::Find hit", numKeys, TimePerKey( keys, [&trie]( std::basic_string< char > const& key )
+  {
+    return trie.Find( key ) != nullptr;
+  } ) );
+  Report( "DoubleArrayTrie::Find hit", numKeys, TimePerKey( keys, [&doubleArray]( std::basic_string< char > const& key )
+  {
+    return doubleArray.HasString( key );
+  } ) );
+  Report( trieName + "::Find miss", numKeys, TimePerKey( misses, [&trie]( std::basic_string< char > const& key )
+  {
+    return trie.Find( key ) != nullptr;
+  } ) );
+  Report( "DoubleArrayTrie::Find miss", numKeys, TimePerKey( misses, [&doubleArray]( std::basic_string< char > const& key )
+  {
+    return doubleArray.HasString( key );
+  } ) );
+}
+
+template< typename TrieTy >
+static void BenchmarkBuildFromSorted( std::basic_string< char > const& trieName, size_t const numKeys )
+{
+  auto keys { RandomWords( numKeys, 4ULL ) };
+  std::sort( keys.begin(), keys.end() );
+
+  // build first so neither run reuses memory freed by the other
+  auto const buildStart { std::chrono::steady_clock::now() };
+  auto const built { TrieTy::BuildFromSorted( keys.begin(), keys.end() ) };
+  auto const buildStop { std::chrono::steady_clock::now() };
+  TrieTy inserted;
+  for( auto const& key : keys )
+  {
+    inserted.Insert( key );
+  }
+  auto const insertStop { std::chrono::steady_clock::now() };
+
+  Report( trieName + "::Insert sorted", numKeys, std::chrono::duration< double, std::nano >( insertStop - buildStop ).count() / static_cast< double >( numKeys ) );
+  Report( trieName + "::BuildFromSorted", numKeys, std::chrono::duration< double, std::nano >( buildStop - buildStart ).count() / static_cast< double >( numKeys ) );
+}
+
+// Hundreds of lookups per request, answered one Find at a time or as a batch
+template< typename TrieTy >
+static void BenchmarkFindBatch( std::basic_string< char > const& trieName, size_t const numKeys )
+{
+  static size_t const BatchSize { 256ULL };
+  auto const keys { RandomWords( numKeys, 1ULL ) };
+  auto queries { RandomWords( numKeys, 2ULL ) };
+  for( size_t i { 0ULL }; i < queries.size(); i += 2ULL )
+  {
+    queries[i] = keys[( i * 7919ULL ) % keys.size()];
+  }
+
+  TrieTy trie;
+  for( auto const& key : keys )
+  {
+    trie.Insert( key );
+  }
+
+  std::vector< std::vector< std::basic_string< char > > > batches;
+  for( size_t i { 0ULL }; i < queries.size(); i += BatchSize )
+  {
+    batches.emplace_back( queries.begin() + static_cast< std::ptrdiff_t >( i ), queries.begin() + static_cast< std::ptrdiff_t >( std::min( i + BatchSize, queries.size() ) ) );
+  }
+
+  Report( trieName + "::Find loop", numKeys, TimePerKey( queries, [&trie]( std::basic_string< char > const& key )
+  {
+    return trie.Find( key ) != nullptr;
+  } ) );
+
+  size_t found { 0ULL };
+  std::vector< typename TrieTy::NodePtr > nodes;
+  auto const start { std::chrono::steady_clock::now() };
+  for( auto const& batch : batches )
+  {
+    trie.FindBatch( batch, nodes );
+    found += static_cast< size_t >( std::count( nodes.begin(), nodes.end(), nullptr ) );
+  }
+  auto const stop { std::chrono::steady_clock::now() };
+  if( found == std::numeric_limits< size_t >::max() )
+  {
+    std::cout << found;
+  }
+  Report( trieName + "::FindBatch", numKeys, std::chrono::duration< double, std::nano >( stop - start ).count() / static_cast< double >( queries.size() ) );
+}
+
+// Every keyword occurrence in a text, restarting at each offset or in one
+// pass of the compiled automaton
+template< typename TrieTy >
+static void BenchmarkAhoCorasick( std::basic_string< char > const& trieName, size_t const numKeys )
+{
+  static size_t const TextLength { 1ULL << 20 };
+  auto const keys { RandomWords( numKeys, 1ULL ) };
+  auto const filler { RandomWords( TextLength / 8ULL, 3ULL ) };
+  std::basic_string< char > text;
+  for( size_t i { 0ULL }; text.size() < TextLength; ++i )
+  {
+    text += ( i % 4ULL == 0ULL ) ? keys[i % keys.size()] : filler[i % filler.size()];
+  }
+
+  TrieTy trie;
+  for( auto const& key : keys )
+  {
+    trie.Insert( key );
+  }
+  auto const automaton { trie.Compile() };
+
+  size_t restartMatches { 0ULL };
+  auto const restartStart { std::chrono::steady_clock::now() };
+  for( size_t offset { 0ULL }; offset < text.size(); ++offset )
+  {
+    trie.ForEachPrefixOf( text.cbegin() + static_cast< std::ptrdiff_t >( offset ), text.cend(), [&restartMatches]( size_t const, typename TrieTy::NodePtr const& )
+    {
+      ++restartMatches;
+    } );
+  }
+  auto const restartStop { std::chrono::steady_clock::now() };
+
+  size_t scanMatches { 0ULL };
+  automaton.Scan( text, [&scanMatches]( size_t const, typename TrieTy::NodePtr const& )
+  {
+    ++scanMatches;
+  } );
+  auto const scanStop { std::chrono::steady_clock::now() };
+
+  if( restartMatches != scanMatches )
+  {
+    std::cout << "match counts differ\n";
+  }
+  Report( trieName + " restart, ns/char", numKeys, std::chrono::duration< double, std::nano >( restartStop - restartStart ).count() / static_cast< double >( text.size() ) );
+  Report( "AhoCorasick::Scan, ns/char", numKeys, std::chrono::duration< double, std::nano >( scanStop - restartStop ).count() / static_cast< double >( text.size() ) );
+}
+
+// Typo tolerant lookup, against computing the distance to every key
+template< typename TrieTy >
+static void BenchmarkFuzzyFind( std::basic_string< char > const& trieName, size_t const numKeys )
+{
+  static size_t const NumQueries { 100ULL };
+  static size_t const MaxDistance { 2ULL };
+  auto const keys { RandomWords( numKeys, 1ULL ) };
+  auto queries { RandomWords( NumQueries, 2ULL ) };
+  for( size_t i { 0ULL }; i < NumQueries; i += 2ULL )
+  {
+    queries[i] = keys[i];
+    queries[i][0] = 'z';
+  }
+
+  TrieTy trie;
+  for( auto const& key : keys )
+  {
+    trie.Insert( key );
+  }
+
+  auto const strings { trie.GetAllStrings() };
+  std::vector< size_t > row;
+  Report( "Edit distance to every key", numKeys, TimePerKey( queries, [&strings, &row]( std::basic_string< char > const& query )
+  {
+    size_t numMatches { 0ULL };
+    for( auto const& str : strings )
+    {
+      row.resize( query.size() + 1ULL );
+      for( size_t j { 0ULL }; j <= query.size(); ++j )
+      {
+        row[j] = j;
+      }
+      for( size_t i { 1ULL }; i <= str.size(); ++i )
+      {
+        auto diagonal { row[0] };
+        row[0] = i;
+        for( size_t j { 1ULL }; j <= query.size(); ++j )
+        {
+          auto const above { row[j] };
+          row[j] = std::min( { above + 1ULL, row[j - 1ULL] + 1ULL, diagonal + ( str[i - 1ULL] == query[j - 1ULL] ? 0ULL : 1ULL ) } );
+          diagonal = above;
+        }
+      }
+      numMatches += ( row[query.size()] <= MaxDistance ) ? 1ULL : 0ULL;
+    }
+    return numMatches != 0ULL;
+  } ) );
+  Report( trieName + "::FuzzyFind", numKeys, TimePerKey( queries, [&trie]( std::basic_string< char > const& query )
+  {
+    return !trie.FuzzyFind( query, MaxDistance ).empty();
+  } ) );
+}
+
+// Glob matching by guided traversal, against filtering every key, per pattern
+template< typename TrieTy >
+static void BenchmarkMatch( std::basic_string< char > const& trieName, size_t const numKeys )
+{
+  auto const keys { RandomWords( numKeys, 1ULL ) };
+  TrieTy trie;
+  for( auto const& key : keys )
+  {
+    trie.Insert( key );
+  }
+
+  std::vector< std::basic_string< char > > const patterns { "ab*", "q?z*", "[a-c]x*e", "m*[xyz]" };
+  auto const matches = []( TriePattern< char > const& pattern, std::basic_string< char > const& str )
+  {
+    std::vector< size_t > positions;
+    std::vector< size_t > next;
+    pattern.Start( positions );
+    for( auto const c : str )
+    {
+      pattern.Step( positions, c, next );
+      positions.swap( next );
+    }
+    return pattern.IsAccepting( positions );
+  };
+
+  Report( trieName + " filter GetAllStrings", numKeys, TimePerKey( patterns, [&trie, &matches]( std::basic_string< char > const& pattern )
+  {
+    TriePattern< char > const compiled { pattern };
+    size_t numMatches { 0ULL };
+    for( auto const& str : trie.GetAllStrings() )
+    {
+      numMatches += matches( compiled, str ) ? 1ULL : 0ULL;
+    }
+    return numMatches != 0ULL;
+  } ) );
+  Report( trieName + "::Match", numKeys, TimePerKey( patterns, [&trie]( std::basic_string< char > const& pattern )
+  {
+    return !trie.Match( pattern ).empty();
+  } ) );
+}
+
+// Ten best completions of short prefixes, against collecting the prefix's
+// entries from a DataTrie and partially sorting them
+static void BenchmarkTopKWithPrefix( size_t const numKeys )
+{
+  static size_t const K { 10ULL };
+  auto const keys { RandomWords( numKeys, 1ULL ) };
+  std::mt19937_64 random { 4ULL };
+  DataTrie< char, int > dataTrie;
+  RankedDataTrie< char, int > rankedTrie;
+  for( auto const& key : keys )
+  {
+    auto const score { static_cast< int >( random() % 1000000ULL ) };
+    dataTrie.Insert( key, score );
+    rankedTrie.Insert( key, score );
+  }
+
+  std::vector< std::basic_string< char > > prefixes { "" };
+  for( size_t i { 0ULL }; i < keys.size(); i += std::max< size_t >( keys.size() / 64ULL, 1ULL ) )
+  {
+    prefixes.push_back( keys[i].substr( 0ULL, 1ULL + i % 2ULL ) );
+  }
+
+  Report( "DataTrie PrefixRange + partial_sort", numKeys, TimePerKey( prefixes, [&dataTrie]( std::basic_string< char > const& prefix )
+  {
+    std::vector< std::pair< int, std::basic_string< char > > > completions;
+    for( auto const& pair : dataTrie.PrefixRange( prefix ) )
+    {
+      completions.push_back( { -pair.second->GetData(), pair.first } );
+    }
+    auto const k { std::min( K, completions.size() ) };
+    std::partial_sort( completions.begin(), completions.begin() + k, completions.end() );
+    return k != 0ULL;
+  } ) );
+  Report( "RankedDataTrie::TopKWithPrefix", numKeys, TimePerKey( prefixes, [&rankedTrie]( std::basic_string< char > const& prefix )
+  {
+    return !rankedTrie.TopKWithPrefix( prefix, K ).empty();
+  } ) );
+}
+
+// Prefix counts and selects by position, against enumerating every entry
+static void BenchmarkRankSelect( size_t const numKeys )
+{
+  auto const keys { RandomWords( numKeys, 1ULL ) };
+  Trie< char > trie;
+  CountedTrie< char > countedTrie;
+  for( auto const& key : keys )
+  {
+    trie.Insert( key );
+    countedTrie.Insert( key );
+  }
+
+  std::vector< std::basic_string< char > > prefixes;
+  for( size_t i { 0ULL }; i < keys.size(); i += std::max< size_t >( keys.size() / 64ULL, 1ULL ) )
+  {
+    prefixes.push_back( keys[i].substr( 0ULL, 1ULL + i % 2ULL ) );
+  }
+
+  Report( "Trie count GetAllStrings", numKeys, TimePerKey( prefixes, [&trie]( std::basic_string< char > const& prefix )
+  {
+    auto const strings { trie.GetAllStrings() };
+    return std::count_if( strings.begin(), strings.end(), [&prefix]( std::basic_string< char > const& str )
+    {
+      return str.compare( 0ULL, prefix.size(), prefix ) == 0;
+    } ) != 0;
+  } ) );
+  Report( "CountedTrie::CountPrefix", numKeys, TimePerKey( prefixes, [&countedTrie]( std::basic_string< char > const& prefix )
+  {
+    return countedTrie.CountPrefix( prefix ) != 0ULL;
+  } ) );
+  Report( "CountedTrie::Rank", numKeys, TimePerKey( keys, [&countedTrie]( std::basic_string< char > const& key )
+  {
+    return countedTrie.Rank( key ) < countedTrie.CountPrefix( "" );
+  } ) );
+  size_t index { 0ULL };
+  Report( "CountedTrie::Select", numKeys, TimePerKey( keys, [&countedTrie, &index, numKeys]( std::basic_string< char > const& )
+  {
+    index = ( index + 7919ULL ) % numKeys;
+    return countedTrie.Select( index ).second != nullptr;
+  } ) );
+}
+
+// Inserts and finds of CJK words, with wide nodes against UTF-8 over byte
+// nodes, which need three nodes per character
+static void BenchmarkUtf8Trie( size_t const numKeys )
+{
+  std::vector< std::basic_string< char32_t > > keys;
+  for( auto const& word : RandomWords( numKeys, 1ULL ) )
+  {
+    std::basic_string< char32_t > key;
+    for( auto const c : word )
+    {
+      key.push_back( static_cast< char32_t >( 0x4E00 + ( c - 'a' ) * 811 ) );
+    }
+    keys.push_back( std::move( key ) );
+  }
+
+  auto const timePerKey = [&keys]( auto&& fn )
+  {
+    auto const start { std::chrono::steady_clock::now() };
+    size_t found { 0ULL };
+    for( auto const& key : keys )
+    {
+      found += fn( key ) ? 1ULL : 0ULL;
+    }
+    auto const stop { std::chrono::steady_clock::now() };
+    if( found == std::numeric_limits< size_t >::max() )
+    {
+      std::cout << found;
+    }
+    return std::chrono::duration< double, std::nano >( stop - start ).count() / static_cast< double >( keys.size() );
+  };
+
+  Trie< char32_t > wideTrie;
+  Utf8Trie< char32_t > utf8Trie;
+  Report( "Trie<char32_t>::Insert", numKeys, timePerKey( [&wideTrie]( std::basic_string< char32_t > const& key )
+  {
+    return wideTrie.Insert( key ) != nullptr;
+  } ) );
+  Report( "Utf8Trie<char32_t>::Insert", numKeys, timePerKey( [&utf8Trie]( std::basic_string< char32_t > const& key )
+  {
+    return utf8Trie.Insert( key ) != nullptr;
+  } ) );
+  Report( "Trie<char32_t>::Find hit", numKeys, timePerKey( [&wideTrie]( std::basic_string< char32_t > const& key )
+  {
+    return wideTrie.Find( key ) != nullptr;
+  } ) );
+  Report( "Utf8Trie<char32_t>::Find hit", numKeys, timePerKey( [&utf8Trie]( std::basic_string< char32_t > const& key )
+  {
+    return utf8Trie.Find( key ) != nullptr;
+  } ) );
+}
+
+// Cost of keeping node and entry counters, and of walking the trie for them
+static void BenchmarkStats( size_t const numKeys )
+{
+  auto const keys { RandomWords( numKeys, 13ULL ) };
+  Trie< char > trie;
+  Trie< char, CountingNodeAllocator<> > countingTrie;
+  Report( "Trie::Insert", numKeys, TimePerKey( keys, [&trie]( std::basic_string< char > const& key )
+  {
+    return trie.Insert( key ) != nullptr;
+  } ) );
+  Report( "Trie<CountingNodeAllocator>::Insert", numKeys, TimePerKey( keys, [&countingTrie]( std::basic_string< char > const& key )
+  {
+    return countingTrie.Insert( key ) != nullptr;
+  } ) );
+
+  TrieStats stats;
+  auto const start { std::chrono::steady_clock::now() };
+  trie.GetStats( stats );
+  auto const statsNs { std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count() };
+  Report( "Trie::GetStats per node", stats.numNodes, statsNs / static_cast< double >( stats.numNodes ) );
+  if( countingTrie.GetNumNodes() != stats.numNodes )
+  {
+    std::cout << "CountingNodeAllocator node count differs from GetStats\n";
+  }
+  Report( "Trie::Remove", numKeys, TimePerKey( keys, [&trie]( std::basic_string< char > const& key )
+  {
+    return trie.Remove( key ) != nullptr;
+  } ) );
+  Report( "Trie<CountingNodeAllocator>::Remove", numKeys, TimePerKey( keys, [&countingTrie]( std::basic_string< char > const& key )
+  {
+    return countingTrie.Remove( key ) != nullptr;
+  } ) );
+}
+
+// Cost of the instrumentation policy on the hot paths, the default policy
+// should match an uninstrumented build
+template< typename TrieTy >
+static void BenchmarkInstrumentation( std::basic_string< char > const& trieName, size_t const numKeys )
+{
+  auto const keys { RandomWords( numKeys, 14ULL ) };
+  TrieTy trie;
+  Report( trieName + "::Insert", numKeys, TimePerKey( keys, [&trie]( std::basic_string< char > const& key )
+  {
+    return trie.Insert( key ) != nullptr;
+  } ) );
+  Report( trieName + "::Find hit", numKeys, TimePerKey( keys, [&trie]( std::basic_string< char > const& key )
+  {
+    return trie.Find( key ) != nullptr;
+  } ) );
+}
+
+// Tokens checked against a fixed keyword set, half of them keywords
+static void BenchmarkStaticTrie( size_t const numKeys )
+{
+  static constexpr auto sqlKeywords { MakeStaticTrie( "ALTER", "AND", "AS", "ASC", "BETWEEN", "BY", "CASE", "CREATE", "DELETE", "DESC", "DISTINCT",
+                                                      "DROP", "ELSE", "END", "EXISTS", "FROM", "GROUP", "HAVING", "IN", "INDEX", "INNER", "INSERT",
+                                                      "INTO", "IS", "JOIN", "LEFT", "LIKE", "LIMIT", "NOT", "NULL", "ON", "OR", "ORDER", "OUTER",
+                                                      "RIGHT", "SELECT", "SET", "TABLE", "THEN", "UNION", "UPDATE", "VALUES", "WHEN", "WHERE" ) };
+  std::vector< std::basic_string< char > > const keywords { "ALTER", "AND", "AS", "ASC", "BETWEEN", "BY", "CASE", "CREATE", "DELETE", "DESC", "DISTINCT",
+                                                             "DROP", "ELSE", "END", "EXISTS", "FROM", "GROUP", "HAVING", "IN", "INDEX", "INNER", "INSERT",
+                                                             "INTO", "IS", "JOIN", "LEFT", "LIKE", "LIMIT", "NOT", "NULL", "ON", "OR", "ORDER", "OUTER",
+                                                             "RIGHT", "SELECT", "SET", "TABLE", "THEN", "UNION", "UPDATE", "VALUES", "WHEN", "WHERE" };
+
+  auto tokens { RandomWords( numKeys, 11ULL ) };
+  for( size_t i { 0ULL }; i < tokens.size(); i += 2ULL )
+  {
+    tokens[i] = keywords[i % keywords.size()];
+  }
+
+  Trie< char > trie;
+  auto const start { std::chrono::steady_clock::now() };
+  for( auto const& keyword : keywords )
+  {
+    trie.Insert( keyword );
+  }
+  auto const buildNs { std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count() };
+  Report( "Trie build keywords", keywords.size(), buildNs / static_cast< double >( keywords.size() ) );
+
+  Report( "Trie keyword HasString", numKeys, TimePerKey( tokens, [&trie]( std::basic_string< char > const& token )
+  {
+    return trie.HasString( token );
+  } ) );
+  Report( "StaticTrie keyword HasString", numKeys, TimePerKey( tokens, []( std::basic_string< char > const& token )
+  {
+    return sqlKeywords.HasString( token );
+  } ) );
+}
+
+// DNA keys over full byte nodes against nodes with one child slot per base
+template< typename DnaTrieTy >
+static void BenchmarkAlphabet( std::basic_string< char > const& trieName, size_t const numKeys )
+{
+  std::mt19937_64 random { 5ULL };
+  std::vector< std::basic_string< char > > keys;
+  for( size_t i { 0ULL }; i < numKeys; ++i )
+  {
+    std::basic_string< char > key( 20ULL, 'A' );
+    for( auto& c : key )
+    {
+      c = "ACGT"[random() % 4ULL];
+    }
+    keys.push_back( std::move( key ) );
+  }
+
+  auto const heapBefore { HeapBytes() };
+  DnaTrieTy trie;
+  for( auto const& key : keys )
+  {
+    trie.Insert( key );
+  }
+  ReportBytes( trieName + " memory", numKeys, HeapBytes() - heapBefore );
+  Report( trieName + "::Find hit", numKeys, TimePerKey( keys, [&trie]( std::basic_string< char > const& key )
+  {
+    return trie.Find( key ) != nullptr;
+  } ) );
+}
+
+// Mixed workload where writePercent of the operations insert or remove a key
+// and the rest look one up, against a Trie behind a single mutex
+static void BenchmarkConcurrentScaling( size_t const numKeys, size_t const writePercent )
+{
+  static size_t const NumOps { 200000ULL };
+  auto const keys { RandomWords( numKeys, 3ULL ) };
+  auto const suffix { " " + std::to_string( writePercent ) + "% writes" };
+
+  auto const maxThreads { std::max< size_t >( std::thread::hardware_concurrency(), 1ULL ) };
+  for( size_t numThreads { 1ULL }; numThreads <= maxThreads; numThreads *= 2ULL )
+  {
+    ConcurrentTrie< char > concurrentTrie;
+    Trie< char > lockedTrie;
+    std::mutex lock;
+    for( size_t i { 0ULL }; i < numKeys; i += 2ULL )
+    {
+      concurrentTrie.Insert( keys[i] );
+      lockedTrie.Insert( keys[i] );
+    }
+
+    auto const opsPerThread { NumOps / numThreads };
+    ReportThroughput( "ConcurrentTrie" + suffix, numThreads, OpsPerSecond( numThreads, opsPerThread, [&]( size_t const thread, size_t const op )
+    {
+      auto const& key { keys[( thread * opsPerThread + op ) * 7919ULL % numKeys] };
+      if( op % 100ULL >= writePercent )
+      {
+        concurrentTrie.HasString( key );
+      }
+      else if( op % 2ULL == 0ULL )
+      {
+        concurrentTrie.Insert( key );
+      }
+      else
+      {
+        concurrentTrie.Remove( key );
+      }
+    } ) );
+    ReportThroughput( "Trie + std::mutex" + suffix, numThreads, OpsPerSecond( numThreads, opsPerThread, [&]( size_t const thread, size_t const op )
+    {
+      auto const& key { keys[( thread * opsPerThread + op ) * 7919ULL % numKeys] };
+      std::lock_guard< std::mutex > guard { lock };
+      if( op % 100ULL >= writePercent )
+      {
+        lockedTrie.HasString( key );
+      }
+      else if( op % 2ULL == 0ULL )
+      {
+        lockedTrie.Insert( key );
+      }
+      else
+      {
+        lockedTrie.Remove( key );
+      }
+    } ) );
+  }
+}
+#pragma endregion
+
+int main()
+{
+  for( auto const numKeys : { 1000ULL, 100000ULL } )
+  {
+    BenchmarkDoubleArrayFind< Trie< char > >( "Trie", numKeys );
+    BenchmarkDoubleArrayFind< Trie< char, ArenaNodeAllocator > >( "Trie<ArenaNodeAllocator>", numKeys );
+    BenchmarkFindBatch< Trie< char > >( "Trie", numKeys );
+    BenchmarkFindBatch< Trie< char, ArenaNodeAllocator > >( "Trie<ArenaNodeAllocator>", numKeys );
+    BenchmarkAhoCorasick< Trie< char > >( "Trie", numKeys );
+    BenchmarkFuzzyFind< Trie< char > >( "Trie", numKeys );
+    BenchmarkMatch< Trie< char > >( "Trie", numKeys );
+    BenchmarkTopKWithPrefix( numKeys );
+    BenchmarkRankSelect( numKeys );
+    BenchmarkUtf8Trie( numKeys );
+    BenchmarkStaticTrie( numKeys );
+    BenchmarkStats( numKeys );
+    BenchmarkInstrumentation< Trie< char > >( "Trie", numKeys );
+    BenchmarkInstrumentation< Trie< char, SharedNodeAllocator, FullAlphabet< char >, TrieInstrumentation< false > > >( "Trie<TrieInstrumentation<false>>", numKeys );
+    BenchmarkInstrumentation< Trie< char, SharedNodeAllocator, FullAlphabet< char >, TrieInstrumentation<> > >( "Trie<TrieInstrumentation<>>", numKeys );
+    BenchmarkAlphabet< Trie< char > >( "DNA Trie", numKeys );
+    BenchmarkAlphabet< Trie< char, SharedNodeAllocator, DnaAlphabet > >( "DNA Trie<DnaAlphabet>", numKeys );
+    BenchmarkAlphabet< Trie< char, ArenaNodeAllocator > >( "DNA Trie<ArenaNodeAllocator>", numKeys );
+    BenchmarkAlphabet< Trie< char, ArenaNodeAllocator, DnaAlphabet > >( "DNA Trie<ArenaNodeAllocator, DnaAlphabet>", numKeys );
+    BenchmarkBuildFromSorted< Trie< char > >( "Trie", numKeys );
+    BenchmarkBuildFromSorted< Trie< char, ArenaNodeAllocator > >( "Trie<ArenaNodeAllocator>", numKeys );
+  }
+  for( auto const writePercent : { 10ULL, 50ULL } )
+  {
+    BenchmarkConcurrentScaling( 100000ULL, writePercent );
+  }
+  return 0;
+}
+#endif // COMPILE_TRIE_BENCHMARKS
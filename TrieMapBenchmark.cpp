@@ -0,0 +1,415 @@
+/*
+   Copyright 2020 Kyle LePoidevin-Gonzales
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifdef COMPILE_TRIE_MAP_BENCHMARKS
+#include "Trie/DataTrie.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#if defined( __GLIBC__ )
+#include <malloc.h>
+#endif
+
+// DataTrie against std::map and std::unordered_map on the same synthetic
+// keys, written as CSV or JSON so runs can be compared across commits.
+//   trieMapBenchmark.out [--format csv|json] [--output path] [--max-keys n] [--seed n]
+
+#pragma region Data Sets
+// count distinct keys from next( rng ), in the order they were first made
+template< typename CharTy, typename NextFnTy >
+static std::vector< std::basic_string< CharTy > > const UniqueKeys( size_t const count, uint64_t const seed, NextFnTy&& next,
+                                                                     std::unordered_set< std::basic_string< CharTy > > const& exclude = {} )
+{
+  std::mt19937_64 rng { seed };
+  std::unordered_set< std::basic_string< CharTy > > seen;
+  std::vector< std::basic_string< CharTy > > keys;
+  keys.reserve( count );
+  while( keys.size() < count )
+  {
+    auto key { next( rng ) };
+    if( exclude.count( key ) == 0ULL && seen.insert( key ).second )
+    {
+      keys.push_back( std::move( key ) );
+    }
+  }
+  return keys;
+}
+
+// Printable ASCII of 8 to 24 characters, which share little beyond a few characters
+static std::basic_string< char > const RandomAsciiKey( std::mt19937_64& rng )
+{
+  std::uniform_int_distribution< size_t > length { 8ULL, 24ULL };
+  std::uniform_int_distribution< int > c { ' ', '~' };
+  std::basic_string< char > key( length( rng ), ' ' );
+  for( auto& keyChar : key )
+  {
+    keyChar = static_cast< char >( c( rng ) );
+  }
+  return key;
+}
+
+// A few hosts and path segments, so keys share long prefixes
+static std::basic_string< char > const UrlKey( std::mt19937_64& rng )
+{
+  static char const* const segments[] { "api", "v1", "v2", "users", "orders", "items", "search", "static", "images", "docs",
+                                        "blog", "posts", "comments", "account", "settings", "cart", "products", "reviews" };
+  std::uniform_int_distribution< size_t > host { 0ULL, 31ULL };
+  std::uniform_int_distribution< size_t > numSegments { 1ULL, 4ULL };
+  std::uniform_int_distribution< size_t > segment { 0ULL, sizeof( segments ) / sizeof( segments[0] ) - 1ULL };
+  std::uniform_int_distribution< uint64_t > id { 0ULL, 9999999ULL };
+
+  std::basic_string< char > key { "https://www.example" + std::to_string( host( rng ) ) + ".com" };
+  for( auto i { numSegments( rng ) }; i > 0ULL; --i )
+  {
+    key += '/';
+    key += segments[segment( rng )];
+  }
+  key += '/';
+  key += std::to_string( id( rng ) );
+  return key;
+}
+
+// Syllables and suffixes, so keys share prefixes and suffixes like words do
+static std::basic_string< char > const WordKey( std::mt19937_64& rng )
+{
+  static char const* const syllables[] { "an", "ba", "be", "bi", "ca", "ce", "co", "con", "da", "de", "di", "do", "el", "en", "er",
+                                         "fa", "fi", "ga", "ge", "ha", "he", "in", "is", "ka", "la", "le", "li", "lo", "ma", "me",
+                                         "mi", "mo", "na", "ne", "ni", "no", "or", "pa", "pe", "pi", "pro", "ra", "re", "ri", "ro",
+                                         "sa", "se", "si", "so", "sta", "ta", "te", "ti", "to", "tra", "un", "va", "ve", "vi", "za" };
+  static char const* const suffixes[] { "", "", "", "s", "ed", "ing", "er", "ly", "tion", "ness" };
+  std::uniform_int_distribution< size_t > numSyllables { 1ULL, 5ULL };
+  std::uniform_int_distribution< size_t > syllable { 0ULL, sizeof( syllables ) / sizeof( syllables[0] ) - 1ULL };
+  std::uniform_int_distribution< size_t > suffix { 0ULL, sizeof( suffixes ) / sizeof( suffixes[0] ) - 1ULL };
+
+  std::basic_string< char > key;
+  for( auto i { numSyllables( rng ) }; i > 0ULL; --i )
+  {
+    key += syllables[syllable( rng )];
+  }
+  key += suffixes[suffix( rng )];
+  return key;
+}
+
+// 2 to 6 code points from the first few thousand CJK ideographs
+static std::basic_string< char32_t > const WideKey( std::mt19937_64& rng )
+{
+  std::uniform_int_distribution< size_t > length { 2ULL, 6ULL };
+  std::uniform_int_distribution< uint32_t > c { 0x4E00U, 0x4E00U + 2999U };
+  std::basic_string< char32_t > key( length( rng ), U' ' );
+  for( auto& keyChar : key )
+  {
+    keyChar = static_cast< char32_t >( c( rng ) );
+  }
+  return key;
+}
+#pragma endregion
+
+#pragma region Containers
+template< typename CharTy, typename AllocTy, typename AlphabetTy >
+static void Insert( DataTrie< CharTy, uint64_t, AllocTy, AlphabetTy >& trie, std::basic_string< CharTy > const& key, uint64_t const value )
+{
+  trie.Insert( key, value );
+}
+
+template< typename MapTy, typename KeyTy >
+static void Insert( MapTy& map, KeyTy const& key, uint64_t const value )
+{
+  map.emplace( key, value );
+}
+
+template< typename CharTy, typename AllocTy, typename AlphabetTy >
+static bool const Find( DataTrie< CharTy, uint64_t, AllocTy, AlphabetTy > const& trie, std::basic_string< CharTy > const& key )
+{
+  return trie.Find( key ) != nullptr;
+}
+
+template< typename MapTy, typename KeyTy >
+static bool const Find( MapTy const& map, KeyTy const& key )
+{
+  return map.find( key ) != map.end();
+}
+
+template< typename CharTy, typename AllocTy, typename AlphabetTy >
+static bool const Remove( DataTrie< CharTy, uint64_t, AllocTy, AlphabetTy >& trie, std::basic_string< CharTy > const& key )
+{
+  return trie.Remove( key ) != nullptr;
+}
+
+template< typename MapTy, typename KeyTy >
+static bool const Remove( MapTy& map, KeyTy const& key )
+{
+  return map.erase( key ) != 0ULL;
+}
+
+// Sum of every value, visiting entries in the container's own order
+template< typename CharTy, typename AllocTy, typename AlphabetTy >
+static uint64_t const SumValues( DataTrie< CharTy, uint64_t, AllocTy, AlphabetTy > const& trie )
+{
+  uint64_t sum { 0ULL };
+  for( auto it { trie.begin() }; it != trie.end(); ++it )
+  {
+    sum += it.GetNode()->GetData();
+  }
+  return sum;
+}
+
+template< typename MapTy >
+static uint64_t const SumValues( MapTy const& map )
+{
+  uint64_t sum { 0ULL };
+  for( auto const& entry : map )
+  {
+    sum += entry.second;
+  }
+  return sum;
+}
+#pragma endregion
+
+#pragma region Results
+struct Result
+{
+  std::basic_string< char > dataset;
+  std::basic_string< char > container;
+  size_t numKeys;
+  std::basic_string< char > operation;
+  double value;
+  std::basic_string< char > unit;
+};
+
+static void WriteCsv( std::ostream& out, std::vector< Result > const& results )
+{
+  out << "dataset,container,keys,operation,value,unit\n";
+  for( auto const& result : results )
+  {
+    out << result.dataset << ',' << result.container << ',' << result.numKeys << ',' << result.operation << ','
+        << std::fixed << std::setprecision( 2 ) << result.value << ',' << result.unit << '\n';
+  }
+}
+
+static void WriteJson( std::ostream& out, std::vector< Result > const& results, uint64_t const seed )
+{
+  out << "{\n  \"seed\": " << seed << ",\n  \"results\": [";
+  for( size_t i { 0ULL }; i < results.size(); ++i )
+  {
+    auto const& result { results[i] };
+    out << ( ( i == 0ULL ) ? "\n" : ",\n" )
+        << "    { \"dataset\": \"" << result.dataset << "\", \"container\": \"" << result.container << "\", \"keys\": " << result.numKeys
+        << ", \"operation\": \"" << result.operation << "\", \"value\": " << std::fixed << std::setprecision( 2 ) << result.value
+        << ", \"unit\": \"" << result.unit << "\" }";
+  }
+  out << "\n  ]\n}\n";
+}
+#pragma endregion
+
+#pragma region Helpers
+// Bytes currently allocated from the heap, or 0 where that is not known
+static size_t const HeapBytes()
+{
+#if defined( __GLIBC__ ) && ( __GLIBC__ > 2 || ( __GLIBC__ == 2 && __GLIBC_MINOR__ >= 33 ) )
+  return mallinfo2().uordblks;
+#else
+  return 0ULL;
+#endif
+}
+
+static double const NsSince( std::chrono::steady_clock::time_point const& start )
+{
+  return std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count();
+}
+
+// Runs fn over every key and returns nanoseconds per key
+template< typename KeyTy, typename FnTy >
+static double const TimePerKey( std::vector< KeyTy > const& keys, FnTy&& fn )
+{
+  size_t found { 0ULL };
+  auto const start { std::chrono::steady_clock::now() };
+  for( auto const& key : keys )
+  {
+    found += fn( key ) ? 1ULL : 0ULL;
+  }
+  auto const nsPerKey { NsSince( start ) / static_cast< double >( keys.size() ) };
+
+  // keep the operations observable
+  if( found == std::numeric_limits< size_t >::max() )
+  {
+    std::cout << found;
+  }
+  return nsPerKey;
+}
+#pragma endregion
+
+#pragma region Benchmarks
+// Every operation on one container, in the order a container lives through
+// them: insert, lookups, enumeration, copy, then removing every key
+template< typename MapTy, typename KeyTy >
+static void BenchmarkContainer( std::basic_string< char > const& dataset, std::basic_string< char > const& container,
+                                std::vector< KeyTy > const& keys, std::vector< KeyTy > const& queries, std::vector< KeyTy > const& misses,
+                                std::vector< Result >& results )
+{
+  auto const record = [&]( std::basic_string< char > const& operation, double const value, std::basic_string< char > const& unit )
+  {
+    results.push_back( { dataset, container, keys.size(), operation, value, unit } );
+  };
+
+  auto const heapBefore { HeapBytes() };
+  MapTy map;
+  uint64_t value { 0ULL };
+  record( "insert", TimePerKey( keys, [&map, &value]( KeyTy const& key )
+  {
+    Insert( map, key, value++ );
+    return true;
+  } ), "ns/op" );
+  auto const heapAfter { HeapBytes() };
+  if( heapAfter != 0ULL )
+  {
+    record( "memory", static_cast< double >( heapAfter - heapBefore ) / static_cast< double >( keys.size() ), "bytes/key" );
+  }
+
+  record( "find_hit", TimePerKey( queries, [&map]( KeyTy const& key )
+  {
+    return Find( map, key );
+  } ), "ns/op" );
+  record( "find_miss", TimePerKey( misses, [&map]( KeyTy const& key )
+  {
+    return Find( map, key );
+  } ), "ns/op" );
+
+  auto start { std::chrono::steady_clock::now() };
+  auto const sum { SumValues( map ) };
+  record( "enumerate", NsSince( start ) / static_cast< double >( keys.size() ), "ns/entry" );
+
+  double copyNs { 0.0 };
+  {
+    start = std::chrono::steady_clock::now();
+    MapTy const copy( map );
+    copyNs = NsSince( start );
+    if( SumValues( copy ) != sum )
+    {
+      std::cerr << container << " copy lost entries\n";
+    }
+  }
+  record( "copy", copyNs / static_cast< double >( keys.size() ), "ns/entry" );
+
+  record( "remove", TimePerKey( queries, [&map]( KeyTy const& key )
+  {
+    return Remove( map, key );
+  } ), "ns/op" );
+}
+
+template< typename CharTy, typename NextFnTy >
+static void BenchmarkDataset( std::basic_string< char > const& dataset, size_t const numKeys, uint64_t const seed, NextFnTy&& next,
+                              std::vector< Result >& results )
+{
+  typedef std::basic_string< CharTy > KeyTy;
+  auto const keys { UniqueKeys< CharTy >( numKeys, seed, next ) };
+  auto const misses { UniqueKeys< CharTy >( numKeys, seed + 1ULL, next, std::unordered_set< KeyTy >( keys.begin(), keys.end() ) ) };
+
+  // look keys up in a different order than they were inserted
+  auto queries { keys };
+  std::shuffle( queries.begin(), queries.end(), std::mt19937_64 { seed + 2ULL } );
+
+  BenchmarkContainer< DataTrie< CharTy, uint64_t > >( dataset, "DataTrie", keys, queries, misses, results );
+  BenchmarkContainer< DataTrie< CharTy, uint64_t, ArenaNodeAllocator > >( dataset, "DataTrie<ArenaNodeAllocator>", keys, queries, misses, results );
+  BenchmarkContainer< std::map< KeyTy, uint64_t > >( dataset, "std::map", keys, queries, misses, results );
+  BenchmarkContainer< std::unordered_map< KeyTy, uint64_t > >( dataset, "std::unordered_map", keys, queries, misses, results );
+}
+#pragma endregion
+
+static int Usage( char const* const name )
+{
+  std::cerr << "Usage: " << name << " [--format csv|json] [--output path] [--max-keys n] [--seed n]\n";
+  return 1;
+}
+
+int main( int argc, char** argv )
+{
+  std::basic_string< char > format { "csv" };
+  std::basic_string< char > outputPath;
+  size_t maxKeys { 100000ULL };
+  uint64_t seed { 1ULL };
+  for( int i { 1 }; i < argc; ++i )
+  {
+    std::basic_string< char > const arg { argv[i] };
+    if( i + 1 == argc )
+    {
+      return Usage( argv[0] );
+    }
+    std::basic_string< char > const value { argv[++i] };
+    if( arg == "--format" && ( value == "csv" || value == "json" ) )
+    {
+      format = value;
+    }
+    else if( arg == "--output" )
+    {
+      outputPath = value;
+    }
+    else if( arg == "--max-keys" )
+    {
+      maxKeys = std::stoull( value );
+    }
+    else if( arg == "--seed" )
+    {
+      seed = std::stoull( value );
+    }
+    else
+    {
+      return Usage( argv[0] );
+    }
+  }
+
+  std::vector< Result > results;
+  for( auto const numKeys : { 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL } )
+  {
+    if( numKeys > maxKeys )
+    {
+      break;
+    }
+    BenchmarkDataset< char >( "ascii", numKeys, seed, RandomAsciiKey, results );
+    BenchmarkDataset< char >( "urls", numKeys, seed, UrlKey, results );
+    BenchmarkDataset< char >( "words", numKeys, seed, WordKey, results );
+    BenchmarkDataset< char32_t >( "wide", numKeys, seed, WideKey, results );
+  }
+
+  std::ofstream file;
+  if( !outputPath.empty() )
+  {
+    file.open( outputPath );
+    if( !file )
+    {
+      std::cerr << "Could not open " << outputPath << '\n';
+      return 1;
+    }
+  }
+  auto& out { outputPath.empty() ? std::cout : file };
+  if( format == "json" )
+  {
+    WriteJson( out, results, seed );
+  }
+  else
+  {
+    WriteCsv( out, results );
+  }
+  return 0;
+}
+#endif // COMPILE_TRIE_MAP_BENCHMARKS
@@ -17,8 +17,28 @@
 #ifdef COMPILE_TRIE_TESTS
 #include "Trie/Trie.h"
 #include "Trie/DataTrie.h"
+#include "Trie/RadixTrie.h"
+#include "Trie/RadixDataTrie.h"
+#include "Trie/DoubleArrayTrie.h"
+#include "Trie/MappedTrie.h"
+#include "Trie/PersistentTrie.h"
+#include "Trie/PersistentDataTrie.h"
+#include "Trie/ConcurrentTrie.h"
+#include "Trie/ShardedDataTrie.h"
+#include "Trie/RankedDataTrie.h"
+#include "Trie/CountedTrie.h"
+#include "Trie/CountedDataTrie.h"
+#include "Trie/Utf8Trie.h"
+#include "Trie/StaticTrie.h"
+#include <cstdio>
 #include <cassert>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
+#include <thread>
 
 typedef std::function< bool() > TestFn;
 
@@ -68,7 +88,8 @@ static TestFn const WrapTrieTest( TestFn const& fn, std::basic_string< char > co
 
 #define WrapTrieTest( f ) WrapTrieTest( f, #f )
 
-bool Populate( Trie< char >& trie )
+template< typename NodeTy >
+bool Populate( BasicTrie< NodeTy, char >& trie )
 {
   for( auto& str : testData )
   {
@@ -77,14 +98,15 @@ bool Populate( Trie< char >& trie )
 
   for( auto& str : testData )
   {
-    auto& node { trie.Find( str.begin(), str.end() ) };
+    auto const& node { trie.Find( str.begin(), str.end() ) };
     TrieTestAssert( node != nullptr );
   }
 
   return true;
 }
 
-bool Populate( DataTrie< char, std::string > & trie )
+template< typename NodeTy >
+bool Populate( BasicDataTrie< NodeTy, char, std::string > & trie )
 {
   for( auto& str : testData )
   {
@@ -182,7 +204,7 @@ bool TestRemove()
   }
 
   // empty the trie
-  std::shared_ptr< TrieNode< char > > lastNode;
+  typename TrieTy::NodePtr lastNode {};
   for( auto& str : nonExistantData )
   {
     lastNode = trie.Remove( str );
@@ -366,6 +388,1647 @@ bool TestAssignment()
   return true;
 }
 
+bool TestArenaReuse()
+{
+  Trie< char, ArenaNodeAllocator > trie;
+
+  for( int round { 0 }; round < 4; ++round )
+  {
+    for( auto const& str : testData )
+    {
+      TrieTestAssert( trie.Insert( str ) != nullptr );
+    }
+    for( auto const& str : nonExistantData )
+    {
+      TrieTestAssert( !trie.HasString( str ) );
+    }
+    for( auto const& str : testData )
+    {
+      trie.Remove( str );
+      TrieTestAssert( !trie.HasString( str ) );
+    }
+    TrieTestAssert( trie.GetAllStrings().empty() );
+  }
+
+  Trie< char, ArenaNodeAllocator > copy;
+  TrieTestAssert( Populate( trie ) );
+  copy = trie;
+  trie = Trie< char, ArenaNodeAllocator > {};
+  TrieTestAssert( trie.GetAllStrings().empty() );
+  TrieTestAssert( copy.GetAllStrings().size() == testData.size() );
+
+  return true;
+}
+
+template< typename TrieTy >
+bool TestRadixSplitMerge()
+{
+  TrieTy trie;
+
+  std::basic_string< char > const prefix { "https://example.com/some/long/path/" };
+  auto const a { trie.Insert( prefix + "a" ) };
+  auto const b { trie.Insert( prefix + "b" ) };
+  TrieTestAssert( a != nullptr && b != nullptr );
+  TrieTestAssert( trie.Find( prefix + "a" ) == a );
+  TrieTestAssert( trie.Find( prefix + "b" ) == b );
+  TrieTestAssert( !trie.HasString( prefix ) );
+  TrieTestAssert( !trie.HasString( "https://example" ) );
+
+  // splitting inside an edge
+  auto const split { trie.Insert( "https://example.com/" ) };
+  TrieTestAssert( split != nullptr );
+  TrieTestAssert( split->GetLabel() == "https://example.com/" );
+  TrieTestAssert( split->GetNumChildren() == 1 );
+  TrieTestAssert( trie.Find( prefix + "a" ) == a );
+
+  // merging back on removal keeps the surviving handles
+  TrieTestAssert( trie.Remove( prefix + "b" ) != nullptr );
+  TrieTestAssert( a->GetLabel() == "some/long/path/a" );
+  TrieTestAssert( trie.Remove( "https://example.com/" ) != nullptr );
+  TrieTestAssert( a->GetLabel() == prefix + "a" );
+  TrieTestAssert( trie.Find( prefix + "a" ) == a );
+  TrieTestAssert( trie.Remove( prefix ) == nullptr );
+
+  auto const strings { trie.GetAllStrings() };
+  TrieTestAssert( strings.size() == 1 && strings.front() == prefix + "a" );
+
+  return true;
+}
+
+template< typename TrieTy >
+bool TestFreeze()
+{
+  TrieTy trie;
+  TrieTestAssert( Populate( trie ) );
+
+  auto const frozen { trie.Freeze() };
+  TrieTestAssert( frozen.GetNumEntries() == testData.size() );
+
+  for( auto const& str : testData )
+  {
+    TrieTestAssert( frozen.HasString( str ) );
+  }
+
+  for( auto const& str : nonExistantData )
+  {
+    TrieTestAssert( !frozen.HasString( str ) );
+  }
+  TrieTestAssert( !frozen.HasString( "" ) );
+
+  auto expectedStrings { trie.GetAllStrings() };
+  auto const actualStrings { frozen.GetAllStrings() };
+  std::sort( expectedStrings.begin(), expectedStrings.end() );
+  TrieTestAssert( actualStrings == expectedStrings );
+
+  for( auto const& pair : frozen.GetAllStringsWithNodes() )
+  {
+    TrieTestAssert( frozen.Find( pair.first ) == pair.second );
+  }
+
+  return true;
+}
+
+bool TestFreezeLarge()
+{
+  DataTrie< char, size_t > trie;
+  std::vector< std::basic_string< char > > keys;
+  for( size_t i { 0ULL }; i < 5000ULL; ++i )
+  {
+    keys.push_back( std::to_string( i * 7919ULL ) + static_cast< char >( 'a' + i % 26 ) );
+    trie.Insert( keys.back(), i );
+  }
+
+  auto const frozen { trie.Freeze() };
+  TrieTestAssert( frozen.GetNumEntries() == keys.size() );
+  for( size_t i { 0ULL }; i < keys.size(); ++i )
+  {
+    auto const data { frozen.FindData( keys[i] ) };
+    TrieTestAssert( data != nullptr && *data == i );
+    TrieTestAssert( !frozen.HasString( keys[i] + "!" ) );
+  }
+
+  auto expectedStrings { keys };
+  std::sort( expectedStrings.begin(), expectedStrings.end() );
+  TrieTestAssert( frozen.GetAllStrings() == expectedStrings );
+
+  return true;
+}
+
+template< typename TrieTy >
+bool TestDoubleArray()
+{
+  TrieTy trie;
+  TrieTestAssert( Populate( trie ) );
+
+  DoubleArrayTrie< char > const doubleArray { trie };
+  TrieTestAssert( doubleArray.GetNumEntries() == testData.size() );
+
+  for( auto const& str : testData )
+  {
+    TrieTestAssert( doubleArray.HasString( str ) );
+  }
+
+  for( auto const& str : nonExistantData )
+  {
+    TrieTestAssert( !doubleArray.HasString( str ) );
+  }
+  TrieTestAssert( !doubleArray.HasString( "" ) );
+
+  return true;
+}
+
+bool TestDoubleArrayData()
+{
+  DataTrie< char, size_t > trie;
+  std::vector< std::basic_string< char > > keys;
+  for( size_t i { 0ULL }; i < 5000ULL; ++i )
+  {
+    keys.push_back( std::to_string( i * 7919ULL ) + static_cast< char >( 'a' + i % 26 ) );
+    trie.Insert( keys.back(), i );
+  }
+  for( int c { std::numeric_limits< char >::min() }; c <= std::numeric_limits< char >::max(); ++c )
+  {
+    keys.push_back( std::basic_string< char >( 2, static_cast< char >( c ) ) );
+    trie.Insert( keys.back(), keys.size() - 1ULL );
+  }
+
+  DoubleArrayDataTrie< char, size_t > doubleArray { trie };
+  auto const copy { doubleArray };
+  for( size_t i { 0ULL }; i < keys.size(); ++i )
+  {
+    auto const data { copy.FindData( keys[i] ) };
+    TrieTestAssert( data != nullptr && *data == i );
+    TrieTestAssert( !copy.HasString( keys[i] + "!" ) );
+  }
+
+  return true;
+}
+
+bool TestMappedTrie()
+{
+  static char const* const path { "trieTest.mapped" };
+
+  DataTrie< char, std::basic_string< char > > trie;
+  TrieTestAssert( Populate( trie ) );
+
+  TrieTestAssert( WriteTrieFile( path, DoubleArrayTrie< char > { trie } ) );
+  MappedTrie< char > mapped;
+  TrieTestAssert( mapped.Open( path ) );
+  TrieTestAssert( mapped.GetNumEntries() == testData.size() );
+  for( auto const& str : testData )
+  {
+    TrieTestAssert( mapped.HasString( str ) );
+  }
+  for( auto const& str : nonExistantData )
+  {
+    TrieTestAssert( !mapped.HasString( str ) );
+  }
+
+  // data tries only open files written with a matching codec
+  MappedDataTrie< char, size_t > wrongData;
+  TrieTestAssert( !wrongData.Open( path ) );
+  MappedTrie< char16_t > wrongChar;
+  TrieTestAssert( !wrongChar.Open( path ) );
+
+  TrieTestAssert( WriteTrieFile( path, DoubleArrayDataTrie< char, std::basic_string< char > > { trie } ) );
+  MappedDataTrie< char, std::basic_string< char > > mappedData;
+  TrieTestAssert( mappedData.Open( path ) );
+  for( auto const& str : testData )
+  {
+    auto const state { mappedData.Find( str ) };
+    TrieTestAssert( state != MappedTrie< char >::NotFound );
+    TrieTestAssert( mappedData.GetData( state ) == str );
+  }
+
+  DataTrie< char, size_t > sizeTrie;
+  for( size_t i { 0ULL }; i < testData.size(); ++i )
+  {
+    sizeTrie.Insert( testData[i], i );
+  }
+  TrieTestAssert( WriteTrieFile( path, DoubleArrayDataTrie< char, size_t > { sizeTrie } ) );
+  MappedDataTrie< char, size_t > mappedSize;
+  TrieTestAssert( mappedSize.Open( path ) );
+  for( size_t i { 0ULL }; i < testData.size(); ++i )
+  {
+    size_t const& data { mappedSize.GetData( mappedSize.Find( testData[i] ) ) };
+    TrieTestAssert( data == i );
+  }
+
+  // moving hands the mapping over and leaves the source closed
+  MappedDataTrie< char, size_t > movedSize { std::move( mappedSize ) };
+  TrieTestAssert( !mappedSize.IsOpen() && mappedSize.Find( testData.front() ) == MappedTrie< char >::NotFound );
+  TrieTestAssert( movedSize.IsOpen() && movedSize.GetData( movedSize.Find( testData.back() ) ) == testData.size() - 1ULL );
+  mappedSize = std::move( movedSize );
+  TrieTestAssert( !movedSize.IsOpen() && mappedSize.GetNumEntries() == testData.size() );
+
+  // files whose entries or value offsets point outside the mapping are rejected
+  static char const* const corruptPath { "trieTestCorrupt.mapped" };
+  auto const openCorrupted = [&trie]( auto const& positionOf, auto const value )
+  {
+    WriteTrieFile( corruptPath, DoubleArrayDataTrie< char, std::basic_string< char > > { trie } );
+    TrieFileHeader header;
+    std::fstream file { corruptPath, std::ios::in | std::ios::out | std::ios::binary };
+    file.read( reinterpret_cast< char* >( &header ), sizeof( header ) );
+    file.seekp( static_cast< std::streamoff >( positionOf( header ) ) );
+    file.write( reinterpret_cast< char const* >( &value ), sizeof( value ) );
+    file.close();
+    return MappedDataTrie< char, std::basic_string< char > > {}.Open( corruptPath );
+  };
+  TrieTestAssert( openCorrupted( []( TrieFileHeader const& header ) { return header.dataOffset; }, uint64_t { 0ULL } ) );
+  TrieTestAssert( !openCorrupted( []( TrieFileHeader const& header ) { return header.dataOffset + sizeof( uint64_t ); }, uint64_t { 1000ULL } ) );
+  TrieTestAssert( !openCorrupted( []( TrieFileHeader const& header )
+  {
+    return header.dataOffset + header.numEntries * sizeof( uint64_t );
+  }, uint64_t { 1000000ULL } ) );
+  TrieTestAssert( !openCorrupted( []( TrieFileHeader const& header ) { return header.entriesOffset; }, static_cast< int32_t >( testData.size() ) ) );
+  std::remove( corruptPath );
+
+  // the mapping outlives the file's directory entry
+  std::remove( path );
+  TrieTestAssert( mappedSize.HasString( testData.front() ) );
+  TrieTestAssert( !MappedTrie< char > {}.Open( path ) );
+
+  return true;
+}
+
+bool TestPersistentTrie()
+{
+  PersistentDataTrie< char, std::basic_string< char > > trie;
+  for( auto const& str : testData )
+  {
+    TrieTestAssert( trie.Insert( str, str ) != nullptr );
+  }
+
+  auto const before { trie.Snapshot() };
+  auto const copy { trie };
+  TrieTestAssert( trie.Remove( "tea" ) );
+  TrieTestAssert( !trie.Remove( "tea" ) );
+  TrieTestAssert( !trie.Remove( "te" ) );
+  TrieTestAssert( trie.Remove( "inn" ) );
+  TrieTestAssert( trie.Insert( "tent", "tent" ) != nullptr );
+
+  // older versions are unaffected by later updates
+  for( auto const& str : testData )
+  {
+    auto const node { before.Find( str ) };
+    TrieTestAssert( node != nullptr && node->GetData() == str );
+    TrieTestAssert( copy.HasString( str ) );
+  }
+  TrieTestAssert( !before.HasString( "tent" ) );
+
+  auto expectedStrings { testData };
+  expectedStrings.erase( std::find( expectedStrings.begin(), expectedStrings.end(), "tea" ) );
+  expectedStrings.erase( std::find( expectedStrings.begin(), expectedStrings.end(), "inn" ) );
+  expectedStrings.push_back( "tent" );
+  std::sort( expectedStrings.begin(), expectedStrings.end() );
+  TrieTestAssert( trie.GetAllStrings() == expectedStrings );
+  TrieTestAssert( before.GetAllStrings().size() == testData.size() );
+
+  // removing everything trims back to a bare root
+  for( auto const& str : expectedStrings )
+  {
+    TrieTestAssert( trie.Remove( str ) );
+  }
+  TrieTestAssert( trie.Snapshot().GetRoot()->GetNumChildren() == 0ULL );
+
+  return true;
+}
+
+bool TestPersistentTrieReaders()
+{
+  static size_t const NumKeys { 2000ULL };
+  PersistentTrie< char > trie;
+
+  // every snapshot holds a prefix of the writer's keys
+  std::atomic< bool > consistent { true };
+  std::vector< std::thread > readers;
+  for( size_t r { 0ULL }; r < 3ULL; ++r )
+  {
+    readers.emplace_back( [&trie, &consistent]()
+    {
+      while( !trie.HasString( std::to_string( NumKeys - 1ULL ) ) )
+      {
+        auto const snapshot { trie.Snapshot() };
+        auto const numStrings { snapshot.GetAllStrings().size() };
+        for( size_t i { 0ULL }; i < NumKeys; i += 97ULL )
+        {
+          if( snapshot.HasString( std::to_string( i ) ) != ( i < numStrings ) )
+          {
+            consistent = false;
+          }
+        }
+      }
+    } );
+  }
+
+  for( size_t i { 0ULL }; i < NumKeys; ++i )
+  {
+    trie.Insert( std::to_string( i ) );
+  }
+  for( auto& reader : readers )
+  {
+    reader.join();
+  }
+
+  TrieTestAssert( consistent );
+  TrieTestAssert( trie.GetAllStrings().size() == NumKeys );
+
+  return true;
+}
+
+bool TestConcurrentTrie()
+{
+  ConcurrentTrie< char > trie;
+  for( auto const& str : testData )
+  {
+    TrieTestAssert( trie.Insert( str ) );
+    TrieTestAssert( !trie.Insert( str ) );
+  }
+
+  for( auto const& str : testData )
+  {
+    TrieTestAssert( trie.HasString( str ) );
+  }
+
+  for( auto const& str : nonExistantData )
+  {
+    TrieTestAssert( !trie.HasString( str ) );
+    TrieTestAssert( !trie.Remove( str ) );
+  }
+
+  auto expectedStrings { testData };
+  std::sort( expectedStrings.begin(), expectedStrings.end() );
+  TrieTestAssert( trie.GetAllStrings() == expectedStrings );
+
+  for( auto const& str : testData )
+  {
+    TrieTestAssert( trie.Remove( str ) );
+    TrieTestAssert( !trie.HasString( str ) );
+  }
+  TrieTestAssert( trie.GetAllStrings().empty() );
+
+  // holding a guard in every slot makes the next Enter fail, not spin
+  EpochManager epochs;
+  std::vector< EpochManager::Guard > guards;
+  guards.reserve( EpochManager::NumSlots );
+  for( size_t i { 0ULL }; i < EpochManager::NumSlots; ++i )
+  {
+    guards.push_back( epochs.Enter() );
+  }
+  auto threw { false };
+  try
+  {
+    epochs.Enter();
+  }
+  catch( std::runtime_error const& )
+  {
+    threw = true;
+  }
+  TrieTestAssert( threw );
+  guards.pop_back();
+  auto const guard { epochs.Enter() };
+
+  return true;
+}
+
+bool TestConcurrentTrieThreads()
+{
+  static size_t const NumThreads { 4ULL };
+  static size_t const NumKeys { 3000ULL };
+  ConcurrentTrie< char > trie;
+
+  // writers share prefixes so they contend on the same nodes, each keeps
+  // every other key it inserted
+  std::atomic< bool > consistent { true };
+  std::vector< std::thread > threads;
+  for( size_t t { 0ULL }; t < NumThreads; ++t )
+  {
+    threads.emplace_back( [&trie, &consistent, t]()
+    {
+      for( size_t i { t }; i < NumKeys; i += NumThreads )
+      {
+        auto const key { std::to_string( i ) };
+        if( !trie.Insert( key ) || !trie.HasString( key ) )
+        {
+          consistent = false;
+        }
+        if( i % 2ULL == 1ULL && !trie.Remove( key ) )
+        {
+          consistent = false;
+        }
+      }
+    } );
+  }
+  for( auto& thread : threads )
+  {
+    thread.join();
+  }
+
+  TrieTestAssert( consistent );
+  for( size_t i { 0ULL }; i < NumKeys; ++i )
+  {
+    TrieTestAssert( trie.HasString( std::to_string( i ) ) == ( i % 2ULL == 0ULL ) );
+  }
+  TrieTestAssert( trie.GetAllStrings().size() == NumKeys / 2ULL );
+
+  return true;
+}
+
+bool TestConcurrentTrieRemoveThreads()
+{
+  static size_t const NumThreads { 4ULL };
+  static size_t const NumKeys { 10000ULL };
+  ConcurrentTrie< char > trie;
+  TrieTestAssert( trie.GetNumNodes() == 1ULL );
+  for( size_t i { 0ULL }; i < NumKeys; ++i )
+  {
+    TrieTestAssert( trie.Insert( std::to_string( NumKeys + i ) ) );
+  }
+  TrieTestAssert( trie.GetNumNodes() > NumKeys );
+
+  // keys have the same length so only leaves are entries, and siblings are
+  // removed by different threads so unlinking a branch often finds its
+  // parent locked
+  std::atomic< bool > consistent { true };
+  std::vector< std::thread > threads;
+  for( size_t t { 0ULL }; t < NumThreads; ++t )
+  {
+    threads.emplace_back( [&trie, &consistent, t]()
+    {
+      for( size_t i { t }; i < NumKeys; i += NumThreads )
+      {
+        if( !trie.Remove( std::to_string( NumKeys + i ) ) )
+        {
+          consistent = false;
+        }
+      }
+    } );
+  }
+  for( auto& thread : threads )
+  {
+    thread.join();
+  }
+
+  TrieTestAssert( consistent );
+  TrieTestAssert( trie.GetAllStrings().empty() );
+  TrieTestAssert( trie.GetNumNodes() == 1ULL );
+
+  return true;
+}
+
+bool TestShardedDataTrie()
+{
+  ShardedDataTrie< char, size_t, 4ULL > trie;
+  for( size_t i { 0ULL }; i < testData.size(); ++i )
+  {
+    TrieTestAssert( trie.Insert( testData[i], i ) );
+  }
+
+  for( size_t i { 0ULL }; i < testData.size(); ++i )
+  {
+    size_t data { 0ULL };
+    TrieTestAssert( trie.HasString( testData[i] ) );
+    TrieTestAssert( trie.FindData( testData[i], data ) && data == i );
+  }
+
+  for( auto const& str : nonExistantData )
+  {
+    size_t data { 0ULL };
+    TrieTestAssert( !trie.HasString( str ) );
+    TrieTestAssert( !trie.FindData( str, data ) );
+    TrieTestAssert( !trie.Remove( str ) );
+  }
+
+  // bulk insert from several threads, then check the merged order
+  std::vector< std::pair< std::basic_string< char >, size_t > > pairs;
+  for( size_t i { 0ULL }; i < 2000ULL; ++i )
+  {
+    pairs.push_back( { std::to_string( i * 7919ULL ), i } );
+  }
+  trie.BulkInsert( pairs, 3ULL );
+
+  TrieTestAssert( trie.Remove( "tea" ) );
+  TrieTestAssert( !trie.HasString( "tea" ) );
+
+  std::vector< std::basic_string< char > > expectedStrings;
+  for( auto const& pair : pairs )
+  {
+    expectedStrings.push_back( pair.first );
+  }
+  for( auto const& str : testData )
+  {
+    if( str != "tea" )
+    {
+      expectedStrings.push_back( str );
+    }
+  }
+  std::sort( expectedStrings.begin(), expectedStrings.end() );
+  TrieTestAssert( trie.GetAllStrings() == expectedStrings );
+
+  auto const stringsWithData { trie.GetAllStringsWithData() };
+  TrieTestAssert( stringsWithData.size() == expectedStrings.size() );
+  for( size_t i { 0ULL }; i < stringsWithData.size(); ++i )
+  {
+    size_t data { 0ULL };
+    TrieTestAssert( stringsWithData[i].first == expectedStrings[i] );
+    TrieTestAssert( trie.FindData( expectedStrings[i], data ) && data == stringsWithData[i].second );
+  }
+
+  // move-only data is moved in by Insert and from a moving range
+  ShardedDataTrie< char, std::unique_ptr< size_t >, 4ULL > ownedTrie;
+  TrieTestAssert( ownedTrie.Insert( "tea", std::unique_ptr< size_t > { new size_t { 1ULL } } ) );
+  std::vector< std::pair< std::basic_string< char >, std::unique_ptr< size_t > > > owned;
+  for( auto const& str : testData )
+  {
+    owned.emplace_back( str, std::unique_ptr< size_t > { new size_t { str.size() } } );
+  }
+  ownedTrie.BulkInsert( std::make_move_iterator( owned.begin() ), std::make_move_iterator( owned.end() ), 2ULL );
+  TrieTestAssert( std::all_of( owned.begin(), owned.end(), []( std::pair< std::basic_string< char >, std::unique_ptr< size_t > > const& pair )
+  {
+    return pair.second == nullptr;
+  } ) );
+  TrieTestAssert( ownedTrie.GetAllStrings().size() == testData.size() );
+
+  return true;
+}
+
+// Forward iterator yielding copies of the strings it walks, for
+// TestBuildFromSorted
+class CopyingIterator
+{
+public:
+  typedef std::forward_iterator_tag iterator_category;
+  typedef std::basic_string< char > value_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef value_type const* pointer;
+  typedef value_type reference;
+
+  explicit CopyingIterator( std::vector< value_type >::const_iterator const it )
+    : m_it { it }
+  {
+
+  }
+
+  value_type operator*() const
+  {
+    return *m_it;
+  }
+
+  CopyingIterator& operator++()
+  {
+    ++m_it;
+    return *this;
+  }
+
+  bool operator==( CopyingIterator const& rhs ) const
+  {
+    return m_it == rhs.m_it;
+  }
+
+  bool operator!=( CopyingIterator const& rhs ) const
+  {
+    return m_it != rhs.m_it;
+  }
+
+private:
+  std::vector< value_type >::const_iterator m_it;
+};
+
+template< typename TrieTy >
+bool TestBuildFromSorted()
+{
+  auto sortedData { testData };
+  std::sort( sortedData.begin(), sortedData.end() );
+  sortedData.push_back( sortedData.back() );
+
+  auto const trie { TrieTy::BuildFromSorted( sortedData.begin(), sortedData.end() ) };
+  TrieTestAssert( trie.GetAllStrings() == std::vector< std::basic_string< char > >( sortedData.begin(), sortedData.end() - 1 ) );
+  for( auto const& str : nonExistantData )
+  {
+    TrieTestAssert( !trie.HasString( str ) );
+  }
+
+  // unsorted input still builds the same trie
+  auto const unsorted { TrieTy::BuildFromSorted( testData.begin(), testData.end() ) };
+  TrieTestAssert( unsorted.GetAllStrings() == trie.GetAllStrings() );
+
+  // keys which only live while the iterator is on them
+  auto const copied { TrieTy::BuildFromSorted( CopyingIterator { sortedData.cbegin() }, CopyingIterator { sortedData.cend() } ) };
+  TrieTestAssert( copied.GetAllStrings() == trie.GetAllStrings() );
+
+  return true;
+}
+
+bool TestDataTrieBuildFromSorted()
+{
+  std::vector< std::pair< std::basic_string< char >, size_t > > pairs;
+  for( size_t i { 0ULL }; i < testData.size(); ++i )
+  {
+    pairs.push_back( { testData[i], i } );
+  }
+  std::sort( pairs.begin(), pairs.end() );
+
+  auto const trie { DataTrie< char, size_t, ArenaNodeAllocator >::BuildFromSorted( pairs.begin(), pairs.end() ) };
+  for( auto const& pair : pairs )
+  {
+    auto const node { trie.Find( pair.first ) };
+    TrieTestAssert( node != nullptr && node->GetData() == pair.second );
+  }
+  TrieTestAssert( trie.GetAllStrings().size() == pairs.size() );
+
+  return true;
+}
+
+template< typename TrieTy >
+bool TestFindBatch()
+{
+  TrieTy trie;
+  TrieTestAssert( Populate( trie ) );
+
+  // hits, misses, prefixes and extensions of entries, and the empty string
+  std::vector< std::basic_string< char > > strs { testData };
+  strs.insert( strs.end(), nonExistantData.begin(), nonExistantData.end() );
+  for( auto const& str : testData )
+  {
+    strs.push_back( str.substr( 0ULL, str.size() / 2ULL ) );
+    strs.push_back( str + "z" );
+  }
+
+  auto const nodes { trie.FindBatch( strs ) };
+  auto const hasStrings { trie.HasStringBatch( strs ) };
+  TrieTestAssert( nodes.size() == strs.size() && hasStrings.size() == strs.size() );
+  for( size_t i { 0ULL }; i < strs.size(); ++i )
+  {
+    TrieTestAssert( nodes[i] == trie.Find( strs[i] ) );
+    TrieTestAssert( hasStrings[i] == trie.HasString( strs[i] ) );
+  }
+
+  return true;
+}
+
+template< typename TrieTy >
+bool TestIterators()
+{
+  typedef typename TrieTy::Iterator IteratorTy;
+  static_assert( std::is_same< typename std::iterator_traits< IteratorTy >::iterator_category, std::input_iterator_tag >::value, "Iterators yield pairs by value, so they must be input iterators" );
+
+  TrieTy trie;
+  TrieTestAssert( trie.Begin() == trie.End() );
+  TrieTestAssert( Populate( trie ) );
+
+  auto const strings { trie.GetAllStrings() };
+  std::vector< std::basic_string< char > > iterated;
+  for( auto const& pair : trie )
+  {
+    TrieTestAssert( pair.second == trie.Find( pair.first ) );
+    iterated.push_back( pair.first );
+  }
+  TrieTestAssert( iterated == strings );
+
+  std::vector< std::basic_string< char > > queries { "", "a", "zzzz", "\xff" };
+  queries.insert( queries.end(), nonExistantData.begin(), nonExistantData.end() );
+  for( auto const& str : testData )
+  {
+    queries.push_back( str );
+    queries.push_back( str.substr( 0ULL, str.size() / 2ULL ) );
+    queries.push_back( str + "a" );
+  }
+
+  for( auto const& query : queries )
+  {
+    auto const expected { std::lower_bound( strings.begin(), strings.end(), query ) };
+    auto const it { trie.LowerBound( query ) };
+    TrieTestAssert( ( it == trie.End() ) == ( expected == strings.end() ) );
+    TrieTestAssert( it == trie.End() || it.GetKey() == *expected );
+
+    std::vector< std::basic_string< char > > inRange;
+    for( auto const& pair : trie.PrefixRange( query ) )
+    {
+      inRange.push_back( pair.first );
+    }
+    std::vector< std::basic_string< char > > withPrefix;
+    std::copy_if( strings.begin(), strings.end(), std::back_inserter( withPrefix ), [&query]( std::basic_string< char > const& str )
+    {
+      return str.compare( 0ULL, query.size(), query ) == 0;
+    } );
+    TrieTestAssert( inRange == withPrefix );
+  }
+
+  return true;
+}
+
+template< typename TrieTy >
+bool TestPrefixOf()
+{
+  TrieTy trie;
+  TrieTestAssert( Populate( trie ) );
+
+  std::vector< std::basic_string< char > > inputs { "" };
+  inputs.insert( inputs.end(), nonExistantData.begin(), nonExistantData.end() );
+  for( auto const& str : testData )
+  {
+    inputs.push_back( str );
+    inputs.push_back( str + "zz" );
+    inputs.push_back( str.substr( 0ULL, str.size() / 2ULL ) );
+  }
+
+  for( auto const& input : inputs )
+  {
+    std::vector< size_t > expected;
+    for( size_t length { 1ULL }; length <= input.size(); ++length )
+    {
+      if( trie.HasString( input.substr( 0ULL, length ) ) )
+      {
+        expected.push_back( length );
+      }
+    }
+
+    std::vector< size_t > lengths;
+    bool nodesMatch { true };
+    trie.ForEachPrefixOf( input, [&]( size_t const length, typename TrieTy::NodePtr const& node )
+    {
+      lengths.push_back( length );
+      nodesMatch = nodesMatch && node == trie.Find( input.substr( 0ULL, length ) );
+    } );
+    TrieTestAssert( lengths == expected && nodesMatch );
+
+    auto const longest { trie.LongestPrefixOf( input ) };
+    TrieTestAssert( longest.first == ( expected.empty() ? 0ULL : expected.back() ) );
+    TrieTestAssert( longest.second == ( expected.empty() ? nullptr : trie.Find( input.substr( 0ULL, longest.first ) ) ) );
+  }
+
+  return true;
+}
+
+template< typename TrieTy >
+bool TestAhoCorasick()
+{
+  TrieTy trie;
+  TrieTestAssert( Populate( trie ) );
+  for( auto const& str : { "he", "she", "his", "hers", "a", "aa" } )
+  {
+    trie.Insert( str );
+  }
+
+  std::basic_string< char > text { "ushers ahishe aaaa" };
+  for( size_t i { 0ULL }; i < testData.size(); i += 3ULL )
+  {
+    text += testData[i] + nonExistantData[i % nonExistantData.size()];
+  }
+
+  typedef std::pair< size_t, typename TrieTy::NodePtr > Match;
+  std::vector< Match > expected;
+  for( size_t offset { 0ULL }; offset < text.size(); ++offset )
+  {
+    trie.ForEachPrefixOf( text.begin() + static_cast< std::ptrdiff_t >( offset ), text.end(), [&]( size_t const, typename TrieTy::NodePtr const& node )
+    {
+      expected.push_back( { offset, node } );
+    } );
+  }
+  std::sort( expected.begin(), expected.end() );
+
+  auto const automaton { trie.Compile() };
+  std::vector< Match > matches;
+  automaton.Scan( text, [&matches]( size_t const offset, typename TrieTy::NodePtr const& node )
+  {
+    matches.push_back( { offset, node } );
+  } );
+  std::sort( matches.begin(), matches.end() );
+  TrieTestAssert( matches == expected );
+
+  // chunk boundaries do not lose matches
+  for( size_t chunkSize { 1ULL }; chunkSize <= 7ULL; ++chunkSize )
+  {
+    matches.clear();
+    auto scanner { automaton.NewScanner() };
+    for( size_t i { 0ULL }; i < text.size(); i += chunkSize )
+    {
+      scanner.Scan( text.substr( i, chunkSize ), [&matches]( size_t const offset, typename TrieTy::NodePtr const& node )
+      {
+        matches.push_back( { offset, node } );
+      } );
+    }
+    TrieTestAssert( scanner.GetOffset() == text.size() );
+    std::sort( matches.begin(), matches.end() );
+    TrieTestAssert( matches == expected );
+  }
+
+  return true;
+}
+
+static size_t const EditDistance( std::basic_string< char > const& lhs, std::basic_string< char > const& rhs )
+{
+  std::vector< size_t > row( rhs.size() + 1ULL );
+  for( size_t j { 0ULL }; j <= rhs.size(); ++j )
+  {
+    row[j] = j;
+  }
+  for( size_t i { 1ULL }; i <= lhs.size(); ++i )
+  {
+    auto diagonal { row[0] };
+    row[0] = i;
+    for( size_t j { 1ULL }; j <= rhs.size(); ++j )
+    {
+      auto const above { row[j] };
+      row[j] = std::min( { above + 1ULL, row[j - 1ULL] + 1ULL, diagonal + ( lhs[i - 1ULL] == rhs[j - 1ULL] ? 0ULL : 1ULL ) } );
+      diagonal = above;
+    }
+  }
+  return row[rhs.size()];
+}
+
+template< typename TrieTy >
+bool TestFuzzyFind()
+{
+  TrieTy trie;
+  TrieTestAssert( Populate( trie ) );
+  auto const strings { trie.GetAllStrings() };
+
+  std::vector< std::basic_string< char > > queries { "", "a" };
+  queries.insert( queries.end(), nonExistantData.begin(), nonExistantData.end() );
+  for( size_t i { 0ULL }; i < testData.size(); i += 2ULL )
+  {
+    auto typo { testData[i] };
+    if( !typo.empty() )
+    {
+      typo[typo.size() / 2ULL] = 'q';
+    }
+    queries.push_back( testData[i] );
+    queries.push_back( typo );
+    queries.push_back( typo + "x" );
+  }
+
+  for( auto const& query : queries )
+  {
+    for( size_t maxDistance { 0ULL }; maxDistance <= 2ULL; ++maxDistance )
+    {
+      std::vector< std::pair< std::basic_string< char >, size_t > > expected;
+      for( auto const& str : strings )
+      {
+        auto const distance { EditDistance( str, query ) };
+        if( distance <= maxDistance )
+        {
+          expected.push_back( { str, distance } );
+        }
+      }
+
+      auto const matches { trie.FuzzyFind( query, maxDistance ) };
+      TrieTestAssert( matches.size() == expected.size() );
+      for( size_t i { 0ULL }; i < matches.size(); ++i )
+      {
+        TrieTestAssert( matches[i].key == expected[i].first && matches[i].distance == expected[i].second );
+        TrieTestAssert( matches[i].node == trie.Find( matches[i].key ) );
+      }
+
+      auto const limited { trie.FuzzyFind( query, maxDistance, 2ULL ) };
+      TrieTestAssert( limited.size() == std::min< size_t >( expected.size(), 2ULL ) );
+    }
+  }
+
+  return true;
+}
+
+// Reference glob matcher for TestMatch, classes are single characters or ranges
+static bool const GlobMatches( std::basic_string< char > const& pattern, size_t p, std::basic_string< char > const& str, size_t s )
+{
+  if( p == pattern.size() )
+  {
+    return s == str.size();
+  }
+  if( pattern[p] == '*' )
+  {
+    return GlobMatches( pattern, p + 1ULL, str, s ) || ( s < str.size() && GlobMatches( pattern, p, str, s + 1ULL ) );
+  }
+  if( s == str.size() )
+  {
+    return false;
+  }
+  if( pattern[p] == '[' )
+  {
+    auto const close { pattern.find( ']', p + 2ULL ) };
+    auto const negated { pattern[p + 1ULL] == '!' };
+    auto inClass { false };
+    for( auto i { p + ( negated ? 2ULL : 1ULL ) }; i < close; ++i )
+    {
+      auto const hasRange { i + 2ULL < close && pattern[i + 1ULL] == '-' };
+      auto const hi { hasRange ? pattern[i + 2ULL] : pattern[i] };
+      inClass = inClass || ( pattern[i] <= str[s] && str[s] <= hi );
+      i += hasRange ? 2ULL : 0ULL;
+    }
+    return inClass != negated && GlobMatches( pattern, close + 1ULL, str, s + 1ULL );
+  }
+  return ( pattern[p] == '?' || pattern[p] == str[s] ) && GlobMatches( pattern, p + 1ULL, str, s + 1ULL );
+}
+
+template< typename TrieTy >
+bool TestMatch()
+{
+  TrieTy trie;
+  TrieTestAssert( Populate( trie ) );
+  for( auto const& str : { "tens", "tent", "inert", "a*b", "t" } )
+  {
+    trie.Insert( str );
+  }
+  auto const strings { trie.GetAllStrings() };
+
+  std::vector< std::basic_string< char > > patterns { "", "*", "**", "?", "??", "???*", "t*", "*n", "*e*", "t?n", "te[an-p]",
+                                                      "[!t]*", "[a-z]*", "*[st]", "i*n*", "[A-Z]", "te[!d]*", "?*?*?", "kyle*" };
+  patterns.insert( patterns.end(), testData.begin(), testData.end() );
+  patterns.insert( patterns.end(), nonExistantData.begin(), nonExistantData.end() );
+  for( auto const& pattern : patterns )
+  {
+    std::vector< std::basic_string< char > > expected;
+    std::copy_if( strings.begin(), strings.end(), std::back_inserter( expected ), [&pattern]( std::basic_string< char > const& str )
+    {
+      return GlobMatches( pattern, 0ULL, str, 0ULL );
+    } );
+
+    std::vector< std::basic_string< char > > matched;
+    for( auto const& pair : trie.Match( pattern ) )
+    {
+      TrieTestAssert( pair.second == trie.Find( pair.first ) );
+      matched.push_back( pair.first );
+    }
+    TrieTestAssert( matched == expected );
+  }
+
+  // escapes and unterminated classes match literally
+  TrieTestAssert( trie.Match( "a\\*b" ).size() == 1ULL );
+  TrieTestAssert( trie.Match( "[te" ).empty() );
+
+  return true;
+}
+
+template< typename AllocTy >
+bool TestTopKWithPrefix()
+{
+  RankedDataTrie< char, int, AllocTy > trie;
+  std::map< std::basic_string< char >, int > scores;
+  auto const checkTopK = [&trie, &scores]()
+  {
+    std::vector< std::basic_string< char > > prefixes { "", "t", "te", "ten", "i", "kyle", "z" };
+    prefixes.insert( prefixes.end(), testData.begin(), testData.end() );
+    for( auto const& prefix : prefixes )
+    {
+      // best first, ties in key order
+      std::vector< std::pair< int, std::basic_string< char > > > expected;
+      for( auto const& entry : scores )
+      {
+        if( entry.first.compare( 0ULL, prefix.size(), prefix ) == 0 )
+        {
+          expected.push_back( { -entry.second, entry.first } );
+        }
+      }
+      std::sort( expected.begin(), expected.end() );
+
+      for( auto const k : { 0ULL, 1ULL, 3ULL, 1000ULL } )
+      {
+        auto const completions { trie.TopKWithPrefix( prefix, k ) };
+        TrieTestAssert( completions.size() == std::min< size_t >( k, expected.size() ) );
+        for( size_t i { 0ULL }; i < completions.size(); ++i )
+        {
+          TrieTestAssert( completions[i].first == expected[i].second );
+          TrieTestAssert( completions[i].second->GetData() == -expected[i].first );
+          TrieTestAssert( completions[i].second == trie.Find( completions[i].first ) );
+        }
+      }
+    }
+    return true;
+  };
+
+  std::vector< std::basic_string< char > > keys { testData.begin(), testData.end() };
+  keys.insert( keys.end(), { "tens", "tent", "tenth", "inert", "t" } );
+  for( size_t i { 0ULL }; i < keys.size(); ++i )
+  {
+    auto const score { static_cast< int >( ( i * 7ULL ) % 5ULL ) };
+    TrieTestAssert( trie.Insert( keys[i], score ) != nullptr );
+    scores[keys[i]] = score;
+  }
+  TrieTestAssert( checkTopK() );
+
+  // raising and lowering scores moves entries through the cached bests
+  for( size_t i { 0ULL }; i < keys.size(); i += 2ULL )
+  {
+    auto const score { ( i % 4ULL == 0ULL ) ? 10 : -1 };
+    TrieTestAssert( trie.SetData( keys[i], score ) );
+    scores[keys[i]] = score;
+  }
+  TrieTestAssert( !trie.SetData( "kyle", 1 ) );
+  TrieTestAssert( checkTopK() );
+
+  trie.Insert( keys[1], 20 );
+  scores[keys[1]] = 20;
+  for( size_t i { 2ULL }; i < keys.size(); i += 3ULL )
+  {
+    trie.Remove( keys[i] );
+    scores.erase( keys[i] );
+  }
+  TrieTestAssert( checkTopK() );
+
+  for( auto const& key : keys )
+  {
+    trie.Remove( key );
+  }
+  TrieTestAssert( trie.TopKWithPrefix( "", 10ULL ).empty() );
+
+  return true;
+}
+
+template< typename TrieTy >
+bool TestRankSelect()
+{
+  TrieTy trie;
+  std::set< std::basic_string< char > > keys;
+  auto const checkCounts = [&trie, &keys]()
+  {
+    std::vector< std::basic_string< char > > const sorted { keys.begin(), keys.end() };
+    std::vector< std::basic_string< char > > queries { "", "t", "te", "ten", "tenx", "a", "z", "\xff" };
+    queries.insert( queries.end(), testData.begin(), testData.end() );
+    queries.insert( queries.end(), nonExistantData.begin(), nonExistantData.end() );
+    for( auto const& query : queries )
+    {
+      auto const numWithPrefix { std::count_if( sorted.begin(), sorted.end(), [&query]( std::basic_string< char > const& key )
+      {
+        return key.compare( 0ULL, query.size(), query ) == 0;
+      } ) };
+      TrieTestAssert( trie.CountPrefix( query ) == static_cast< size_t >( numWithPrefix ) );
+      auto const rank { std::lower_bound( sorted.begin(), sorted.end(), query ) - sorted.begin() };
+      TrieTestAssert( trie.Rank( query ) == static_cast< size_t >( rank ) );
+    }
+
+    for( size_t i { 0ULL }; i < sorted.size(); ++i )
+    {
+      auto const selected { trie.Select( i ) };
+      TrieTestAssert( selected.first == sorted[i] && selected.second == trie.Find( sorted[i] ) );
+      TrieTestAssert( trie.Rank( sorted[i] ) == i );
+    }
+    TrieTestAssert( trie.Select( sorted.size() ).second == nullptr );
+    return true;
+  };
+
+  TrieTestAssert( checkCounts() );
+  std::vector< std::basic_string< char > > toInsert { testData.begin(), testData.end() };
+  toInsert.insert( toInsert.end(), { "tens", "tent", "tenth", "t", "ten", "\xff\x01" } );
+  toInsert.push_back( std::basic_string< char >( 40ULL, 'e' ) );
+  for( auto const& key : toInsert )
+  {
+    TrieTestAssert( trie.Insert( key ) != nullptr );
+    keys.insert( key );
+  }
+  TrieTestAssert( checkCounts() );
+
+  // inserting keys already present leaves the counts alone
+  for( auto const& key : toInsert )
+  {
+    TrieTestAssert( trie.Insert( key ) == trie.Find( key ) );
+  }
+  TrieTestAssert( checkCounts() );
+
+  // removing missing keys and prefixes of entries leaves the counts alone
+  for( auto const& key : nonExistantData )
+  {
+    TrieTestAssert( trie.Remove( key ) == nullptr );
+  }
+  for( auto const& key : { "ten", "A", "tenth", "inn" } )
+  {
+    TrieTestAssert( trie.Remove( key ) != nullptr );
+    keys.erase( key );
+  }
+  TrieTestAssert( checkCounts() );
+
+  for( auto const& key : toInsert )
+  {
+    trie.Remove( key );
+    keys.erase( key );
+  }
+  TrieTestAssert( checkCounts() );
+
+  return true;
+}
+
+// Data which counts how often it is copied or moved, for TestEmplace
+struct CopyCounted
+{
+  static size_t numCopies;
+  static size_t numMoves;
+  std::vector< int > payload;
+
+  CopyCounted() = default;
+
+  CopyCounted( CopyCounted&& rhs )
+    : payload { std::move( rhs.payload ) }
+  {
+    ++numMoves;
+  }
+
+  CopyCounted& operator=( CopyCounted&& rhs )
+  {
+    payload = std::move( rhs.payload );
+    ++numMoves;
+    return *this;
+  }
+
+  CopyCounted( size_t const size, int const value )
+    : payload( size, value )
+  {
+
+  }
+
+  CopyCounted( CopyCounted const& rhs )
+    : payload { rhs.payload }
+  {
+    ++numCopies;
+  }
+
+  CopyCounted& operator=( CopyCounted const& rhs )
+  {
+    payload = rhs.payload;
+    ++numCopies;
+    return *this;
+  }
+};
+size_t CopyCounted::numCopies { 0ULL };
+size_t CopyCounted::numMoves { 0ULL };
+
+template< typename TrieTy >
+bool TestEmplace()
+{
+  TrieTy trie;
+  CopyCounted::numCopies = 0ULL;
+
+  // C string keys, moved data and data built in place are never copied
+  TrieTestAssert( trie.Insert( "tea", CopyCounted( 4ULL, 1 ) ) != nullptr );
+
+  // data of new nodes is built in the node, without a temporary to move
+  CopyCounted::numMoves = 0ULL;
+  TrieTestAssert( trie.Emplace( "ted", 8ULL, 2 ) != nullptr );
+  auto const inserted { trie.TryEmplace( "ten", 16ULL, 3 ) };
+  TrieTestAssert( inserted.first != nullptr && inserted.second );
+  auto const existing { trie.TryEmplace( "ten", 1ULL, 4 ) };
+  TrieTestAssert( existing.first == inserted.first && !existing.second );
+  TrieTestAssert( existing.first->GetData().payload == std::vector< int >( 16ULL, 3 ) );
+  TrieTestAssert( CopyCounted::numMoves == 0ULL );
+  TrieTestAssert( trie.HasString( "tea" ) && !trie.HasString( "te" ) );
+
+  // a node already on the path, or split from one, gets its data too
+  auto const prefix { trie.TryEmplace( "te", 2ULL, 9 ) };
+  TrieTestAssert( prefix.second && prefix.first->GetData().payload == std::vector< int >( 2ULL, 9 ) );
+  TrieTestAssert( trie.Remove( "te" ) != nullptr );
+
+  auto const node { trie.Find( "ted" ) };
+  TrieTestAssert( node->GetData().payload.size() == 8ULL );
+  node->GetData().payload.push_back( 5 );
+  node->SetData( CopyCounted( 2ULL, 6 ) );
+  TrieTestAssert( trie.Find( std::basic_string< char > { "ted" } )->GetData().payload.size() == 2ULL );
+
+  // Emplace replaces the data of an existing entry
+  trie.Emplace( "tea", 3ULL, 7 );
+  TrieTestAssert( trie.Find( "tea" )->GetData().payload == std::vector< int >( 3ULL, 7 ) );
+  TrieTestAssert( CopyCounted::numCopies == 0ULL );
+
+  CopyCounted const data { 1ULL, 8 };
+  trie.Insert( "inn", data );
+  TrieTestAssert( CopyCounted::numCopies == 1ULL );
+
+  TrieTestAssert( trie.Remove( "tea" ) != nullptr && !trie.HasString( "tea" ) );
+  TrieTestAssert( trie.GetAllStrings().size() == 3ULL );
+
+  return true;
+}
+
+template< typename CharTy >
+bool TestUtf8Trie()
+{
+  Utf8Trie< CharTy > trie;
+  Utf8DataTrie< CharTy, size_t > dataTrie;
+
+  std::vector< std::basic_string< CharTy > > keys;
+  for( auto const& str : testData )
+  {
+    keys.emplace_back( str.begin(), str.end() );
+  }
+  keys.push_back( { static_cast< CharTy >( 0xE9 ), static_cast< CharTy >( 't' ), static_cast< CharTy >( 0xE9 ) } );
+  keys.push_back( { static_cast< CharTy >( 0x4E2D ), static_cast< CharTy >( 0x6587 ) } );
+  keys.push_back( { static_cast< CharTy >( 0x4E2D ), static_cast< CharTy >( 0x56FD ) } );
+  keys.push_back( { static_cast< CharTy >( 0x7FF ), static_cast< CharTy >( 0x800 ), static_cast< CharTy >( 0xFFFF ) } );
+  if( sizeof( CharTy ) == 2ULL )
+  {
+    // surrogate pairs and unpaired surrogates
+    keys.push_back( { static_cast< CharTy >( 0xD83D ), static_cast< CharTy >( 0xDE00 ) } );
+    keys.push_back( { static_cast< CharTy >( 0xD83D ), static_cast< CharTy >( 0xDE00 ), static_cast< CharTy >( 'a' ) } );
+    keys.push_back( { static_cast< CharTy >( 0xDC00 ), static_cast< CharTy >( 0xD800 ) } );
+  }
+  else
+  {
+    keys.push_back( { static_cast< CharTy >( 0x1F600 ) } );
+    keys.push_back( { static_cast< CharTy >( 0x10FFFF ), static_cast< CharTy >( 0x110000 ) } );
+    keys.push_back( { static_cast< CharTy >( 0x7FFFFFFF ), static_cast< CharTy >( 0xFFFFFFFF ) } );
+  }
+
+  for( size_t i { 0ULL }; i < keys.size(); ++i )
+  {
+    TrieTestAssert( Utf8Codec< CharTy >::Decode( Utf8Codec< CharTy >::Encode( keys[i] ) ) == keys[i] );
+    TrieTestAssert( trie.Insert( keys[i] ) != nullptr );
+    TrieTestAssert( dataTrie.Insert( keys[i], i ) != nullptr );
+  }
+
+  for( size_t i { 0ULL }; i < keys.size(); ++i )
+  {
+    TrieTestAssert( trie.HasString( keys[i] ) );
+    TrieTestAssert( dataTrie.Find( keys[i] )->GetData() == i );
+    auto prefix { keys[i] };
+    prefix.pop_back();
+    TrieTestAssert( !trie.HasString( prefix + static_cast< CharTy >( 0x4E2E ) ) );
+  }
+
+  // code point order, which for UTF-32 is the order of the keys themselves
+  auto expected { keys };
+  std::sort( expected.begin(), expected.end(), []( std::basic_string< CharTy > const& lhs, std::basic_string< CharTy > const& rhs )
+  {
+    return Utf8Codec< CharTy >::Encode( lhs ) < Utf8Codec< CharTy >::Encode( rhs );
+  } );
+  if( std::is_same< CharTy, char32_t >::value )
+  {
+    TrieTestAssert( std::is_sorted( expected.begin(), expected.end() ) );
+  }
+  TrieTestAssert( trie.GetAllStrings() == expected );
+  auto const stringsWithNodes { dataTrie.GetAllStringsWithNodes() };
+  TrieTestAssert( stringsWithNodes.size() == expected.size() );
+  for( size_t i { 0ULL }; i < expected.size(); ++i )
+  {
+    TrieTestAssert( stringsWithNodes[i].first == expected[i] && keys[stringsWithNodes[i].second->GetData()] == expected[i] );
+  }
+
+  DoubleArrayTrie< char > const doubleArray { trie.GetByteTrie() };
+  for( auto const& key : keys )
+  {
+    TrieTestAssert( doubleArray.HasString( Utf8Codec< CharTy >::Encode( key ) ) );
+  }
+
+  for( size_t i { 0ULL }; i < keys.size(); i += 2ULL )
+  {
+    TrieTestAssert( trie.Remove( keys[i] ) != nullptr );
+    TrieTestAssert( !trie.HasString( keys[i] ) );
+  }
+  TrieTestAssert( trie.GetAllStrings().size() == keys.size() / 2ULL );
+
+  return true;
+}
+
+bool TestAlphabet()
+{
+  typedef Trie< char, SharedNodeAllocator, DnaAlphabet > DnaTrie;
+  std::vector< std::basic_string< char > > const keys { "A", "AC", "ACGT", "AGG", "CAT", "GATTACA", "T", "TT" };
+  std::vector< std::basic_string< char > > const outside { "ACGU", "acgt", "N", "AC-GT" };
+
+  DnaTrie trie;
+  for( auto const& key : keys )
+  {
+    TrieTestAssert( trie.Insert( key ) != nullptr );
+  }
+  for( auto const& key : outside )
+  {
+    TrieTestAssert( trie.Insert( key ) == nullptr );
+    TrieTestAssert( trie.Find( key ) == nullptr && !trie.HasString( key ) );
+    TrieTestAssert( trie.Remove( key ) == nullptr );
+  }
+  TrieTestAssert( trie.GetAllStrings() == keys );
+  TrieTestAssert( trie.HasStringBatch( outside ) == std::vector< bool >( outside.size(), false ) );
+
+  // a key outside the alphabet still has a place in key order
+  std::vector< std::basic_string< char > > const bounds { "AB", "ACGTN", "B", "GA", "Z", "" };
+  for( auto const& bound : bounds )
+  {
+    auto const expected { std::lower_bound( keys.begin(), keys.end(), bound ) };
+    auto const it { trie.LowerBound( bound ) };
+    TrieTestAssert( ( it == trie.End() ) == ( expected == keys.end() ) );
+    TrieTestAssert( it == trie.End() || it.GetKey() == *expected );
+  }
+
+  // sorted input with keys outside the alphabet skips them
+  auto withOutside { keys };
+  withOutside.insert( withOutside.end(), outside.begin(), outside.end() );
+  std::sort( withOutside.begin(), withOutside.end() );
+  TrieTestAssert( DnaTrie::BuildFromSorted( withOutside.begin(), withOutside.end() ).GetAllStrings() == keys );
+
+  TrieTestAssert( trie.Match( "[AC]*" ).size() == 5ULL );
+  TrieTestAssert( trie.Match( "[!A]*" ).size() == 4ULL );
+  TrieTestAssert( trie.LongestPrefixOf( "ACGTX" ).first == 4ULL );
+
+  size_t numMatches { 0ULL };
+  trie.Compile().Scan( "xxACGTNTTx", [&numMatches]( size_t const, DnaTrie::NodePtr const& )
+  {
+    ++numMatches;
+  } );
+  TrieTestAssert( numMatches == 7ULL );
+
+  DataTrie< char, int, SharedNodeAllocator, HexAlphabet > hexTrie;
+  TrieTestAssert( hexTrie.Insert( "c0ffee", 1 ) != nullptr && hexTrie.Insert( "coffee", 2 ) == nullptr );
+  TrieTestAssert( hexTrie.Find( "c0ffee" )->GetData() == 1 );
+
+  // non-ASCII members order as unsigned characters, like the full alphabet
+  std::vector< std::basic_string< char > > const accented { "\xE9t\xE9", "a", "a\xE9", "ae", "e\xE9", "\xE9" };
+  Trie< char > fullTrie;
+  Trie< char, SharedNodeAllocator, ListAlphabet< char, 'a', 'e', 't', '\xE9' > > listTrie;
+  Trie< char, SharedNodeAllocator, RangeAlphabet< char, 'a', '\xFF' > > rangeTrie;
+  for( auto const& key : accented )
+  {
+    fullTrie.Insert( key );
+    TrieTestAssert( listTrie.Insert( key ) != nullptr && rangeTrie.Insert( key ) != nullptr );
+  }
+  TrieTestAssert( listTrie.Insert( "b" ) == nullptr && rangeTrie.Insert( "A" ) == nullptr );
+  auto const ordered { fullTrie.GetAllStrings() };
+  TrieTestAssert( ordered.back() == "\xE9t\xE9" );
+  TrieTestAssert( listTrie.GetAllStrings() == ordered && rangeTrie.GetAllStrings() == ordered );
+  std::vector< std::basic_string< char > > iterated;
+  for( auto it { listTrie.Begin() }; it != listTrie.End(); ++it )
+  {
+    iterated.push_back( it.GetKey() );
+  }
+  TrieTestAssert( iterated == ordered && listTrie.LowerBound( "e\xE9" ).GetKey() == "e\xE9" );
+  TrieTestAssert( listTrie.Freeze().GetAllStrings() == ordered && rangeTrie.Freeze().GetAllStrings() == ordered );
+
+  return true;
+}
+
+bool TestStaticTrie()
+{
+  constexpr auto methods { MakeStaticTrie( "GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE", "PATCH", "PUT", "P" ) };
+  static_assert( methods.GetNumEntries() == 10ULL, "Duplicates must be counted once" );
+  static_assert( methods.Find( "GET" ) == 0ULL && methods.Find( "PATCH" ) == 8ULL, "Must find by list position" );
+  static_assert( methods.Find( "PUT" ) == 3ULL, "Must report the first position of a duplicate" );
+  static_assert( methods.Find( "GE" ) == decltype( methods )::NoEntry && !methods.HasString( "GETS" ), "Must not find prefixes or extensions" );
+  static_assert( methods.LongestPrefixOf( "POSTAL" ).first == 4ULL && methods.LongestPrefixOf( "POSTAL" ).second == 2ULL, "Must find the longest prefix" );
+  static_assert( methods.LongestPrefixOf( "PIG" ).first == 1ULL && methods.LongestPrefixOf( "GE" ).second == decltype( methods )::NoEntry, "Must find short prefixes" );
+
+  std::vector< std::basic_string< char > > const keys { "GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE", "PATCH", "PUT", "P" };
+  Trie< char > trie;
+  for( auto const& key : keys )
+  {
+    trie.Insert( key );
+  }
+  auto queries { testData };
+  queries.insert( queries.end(), keys.begin(), keys.end() );
+  queries.push_back( "" );
+  queries.push_back( "POSTS" );
+  queries.push_back( "\xFFGET" );
+  for( auto const& query : queries )
+  {
+    auto const position { methods.Find( query ) };
+    TrieTestAssert( methods.HasString( query ) == trie.HasString( query ) );
+    TrieTestAssert( position == methods.Find( query.c_str() ) && position == methods.Find( query.begin(), query.end() ) );
+    TrieTestAssert( position == methods.NoEntry || keys[position] == query );
+    TrieTestAssert( methods.LongestPrefixOf( query ).first == trie.LongestPrefixOf( query ).first );
+  }
+
+  // wide keys search the root's children like any other node's
+  constexpr auto wideKeywords { MakeStaticTrie( u"\u4E2D\u6587", u"\u4E2D", u"ab", u"" ) };
+  static_assert( wideKeywords.Find( u"\u4E2D" ) == 1ULL && wideKeywords.Find( u"" ) == 3ULL, "Must find wide keys" );
+  TrieTestAssert( wideKeywords.LongestPrefixOf( std::basic_string< char16_t > { u"\u4E2D\u6587\u5B57" } ).second == 0ULL );
+  TrieTestAssert( wideKeywords.LongestPrefixOf( u"abc" ).first == 2ULL && wideKeywords.LongestPrefixOf( u"x" ).second == 3ULL );
+  TrieTestAssert( !wideKeywords.HasString( u"a" ) && wideKeywords.GetNumNodes() == 5ULL );
+
+  return true;
+}
+
+template< typename TrieTy, size_t NumNodes >
+bool TestGetStats()
+{
+  typedef typename std::remove_reference< decltype( *std::declval< TrieTy >().GetRoot() ) >::type NodeTy;
+  TrieTy trie;
+  auto stats { trie.GetStats() };
+  TrieTestAssert( stats.numNodes == 1ULL && stats.numEntries == 0ULL && stats.GetAverageKeyLength() == 0.0 );
+  TrieTestAssert( stats.fanout == std::vector< size_t > { 1ULL } && stats.depth == std::vector< size_t > { 1ULL } );
+
+  Populate( trie );
+  trie.GetStats( stats );
+  TrieTestAssert( stats.numNodes == NumNodes && stats.numEntries == testData.size() );
+  TrieTestAssert( stats.totalKeyLength == 21ULL && stats.GetAverageKeyLength() == 21.0 / 9.0 );
+
+  size_t numFanoutNodes { 0ULL };
+  size_t numChildren { 0ULL };
+  for( size_t i { 0ULL }; i < stats.fanout.size(); ++i )
+  {
+    numFanoutNodes += stats.fanout[i];
+    numChildren += i * stats.fanout[i];
+  }
+  TrieTestAssert( numFanoutNodes == NumNodes && numChildren == NumNodes - 1ULL && stats.fanout.back() == 1ULL );
+  TrieTestAssert( std::accumulate( stats.depth.begin(), stats.depth.end(), 0ULL ) == NumNodes && stats.depth[1] == 4ULL );
+  TrieTestAssert( stats.numNullChildSlots == stats.numChildSlots - ( NumNodes - 1ULL ) );
+  TrieTestAssert( stats.dataBytes == NumNodes * NodeTy::PayloadBytes );
+  TrieTestAssert( stats.nodeBytes >= NumNodes * ( sizeof( NodeTy ) - NodeTy::PayloadBytes ) && stats.childBytes > 0ULL );
+  TrieTestAssert( stats.GetTotalBytes() == stats.nodeBytes + stats.childBytes + stats.dataBytes );
+
+  for( auto const& str : testData )
+  {
+    trie.Remove( str );
+  }
+  trie.GetStats( stats );
+  TrieTestAssert( stats.numNodes == 1ULL && stats.numEntries == 0ULL && stats.totalKeyLength == 0ULL );
+
+  return true;
+}
+
+template< typename TrieTy >
+bool TestNodeCounters()
+{
+  auto const matchesStats = []( TrieTy const& trie )
+  {
+    auto const stats { trie.GetStats() };
+    return trie.GetNumNodes() == stats.numNodes && trie.GetNumEntries() == stats.numEntries;
+  };
+
+  TrieTy trie;
+  TrieTestAssert( trie.GetNumNodes() == 1ULL && trie.GetNumEntries() == 0ULL );
+
+  std::mt19937 random { 7U };
+  std::vector< std::basic_string< char > > keys;
+  for( size_t i { 0ULL }; i < 400ULL; ++i )
+  {
+    std::basic_string< char > key( 1ULL + random() % 6ULL, 'a' );
+    for( auto& c : key )
+    {
+      c = static_cast< char >( 'a' + random() % 3U );
+    }
+    keys.push_back( key );
+  }
+  for( size_t i { 0ULL }; i < keys.size(); ++i )
+  {
+    // inserts and removes keys which may or may not be present
+    if( random() % 3U == 0U )
+    {
+      trie.Remove( keys[i] );
+    }
+    else
+    {
+      trie.Insert( keys[i] );
+    }
+    TrieTestAssert( matchesStats( trie ) );
+  }
+
+  TrieTy copy { trie };
+  TrieTestAssert( matchesStats( copy ) && copy.GetNumEntries() == trie.GetNumEntries() );
+  TrieTy moved { std::move( copy ) };
+  TrieTestAssert( matchesStats( moved ) && moved.GetNumNodes() == trie.GetNumNodes() );
+  for( auto const& key : keys )
+  {
+    moved.Remove( key );
+  }
+  TrieTestAssert( moved.GetNumNodes() == 1ULL && moved.GetNumEntries() == 0ULL );
+
+  return true;
+}
+
+template< typename TrieTy >
+bool TestInstrumentation()
+{
+  typedef typename std::remove_reference< decltype( *std::declval< TrieTy >().GetRoot() ) >::type::Instrumentation InstrumentTy;
+
+  // counts since the last call for each operation, the counters are shared
+  // with every other trie using the same policy
+  TrieOperationStats last[NumTrieOperations] {};
+  for( size_t i { 0ULL }; i < NumTrieOperations; ++i )
+  {
+    last[i] = InstrumentTy::Collect( static_cast< TrieOperation >( i ) );
+  }
+  auto const collect = [&last]( TrieOperation const operation )
+  {
+    auto const stats { InstrumentTy::Collect( operation ) };
+    auto& prev { last[static_cast< size_t >( operation )] };
+    TrieOperationStats diff { stats.numOps - prev.numOps, stats.numHits - prev.numHits,
+                              stats.numNodesVisited - prev.numNodesVisited, stats.numAllocations - prev.numAllocations, {} };
+    for( size_t i { 0ULL }; i < NumTrieLatencyBuckets; ++i )
+    {
+      diff.latency[i] = stats.latency[i] - prev.latency[i];
+    }
+    prev = stats;
+    return diff;
+  };
+  // every operation lands in one latency bucket if they are timed
+  auto const isTimed = []( TrieOperationStats const& stats )
+  {
+    auto const numTimed { std::accumulate( std::begin( stats.latency ), std::end( stats.latency ), 0ULL ) };
+    return numTimed == ( InstrumentTy::RecordsLatency ? stats.numOps : 0ULL );
+  };
+
+  TrieTy trie;
+  Populate( trie );
+  auto stats { collect( TrieOperation::Insert ) };
+  TrieTestAssert( stats.numOps == testData.size() && stats.numHits == testData.size() );
+  TrieTestAssert( stats.numNodesVisited == 21ULL && stats.numAllocations == 13ULL && isTimed( stats ) );
+  stats = collect( TrieOperation::Find );
+  TrieTestAssert( stats.numOps == testData.size() && stats.GetHitRatio() == 1.0 && stats.numNodesVisited == 21ULL );
+
+  // inserting an existing key is a miss and allocates nothing
+  trie.Insert( testData[0] );
+  stats = collect( TrieOperation::Insert );
+  TrieTestAssert( stats.numOps == 1ULL && stats.numHits == 0ULL && stats.numAllocations == 0ULL && stats.numNodesVisited == testData[0].size() );
+
+  for( auto const& str : nonExistantData )
+  {
+    TrieTestAssert( !trie.HasString( str ) );
+  }
+  stats = collect( TrieOperation::Find );
+  TrieTestAssert( stats.numOps == nonExistantData.size() && stats.numHits == 0ULL && stats.numNodesVisited == 5ULL );
+  TrieTestAssert( isTimed( stats ) );
+
+  // counts from a thread which has exited are kept
+  std::thread reader { [&trie]()
+  {
+    for( auto const& str : testData )
+    {
+      trie.Find( str );
+    }
+  } };
+  reader.join();
+  stats = collect( TrieOperation::Find );
+  TrieTestAssert( stats.numOps == testData.size() && stats.numHits == testData.size() );
+
+  for( auto const& str : testData )
+  {
+    trie.Remove( str );
+  }
+  trie.Remove( testData[0] );
+  stats = collect( TrieOperation::Remove );
+  TrieTestAssert( stats.numOps == testData.size() + 1ULL && stats.numHits == testData.size() && isTimed( stats ) );
+  TrieTestAssert( collect( TrieOperation::Insert ).numOps == 0ULL );
+
+  return true;
+}
+
+bool TestAdaptiveChildren()
+{
+  Trie< char > trie;
+
+  // grow the root through every storage kind, including negative chars
+  std::vector< std::basic_string< char > > keys;
+  for( int c { std::numeric_limits< char >::min() }; c <= std::numeric_limits< char >::max(); ++c )
+  {
+    keys.push_back( std::basic_string< char >( 1, static_cast< char >( c ) ) + "x" );
+  }
+
+  for( auto const& key : keys )
+  {
+    TrieTestAssert( trie.Insert( key ) != nullptr );
+  }
+
+  for( auto const& key : keys )
+  {
+    TrieTestAssert( trie.HasString( key ) );
+  }
+
+  TrieTestAssert( trie.GetAllStrings().size() == keys.size() );
+
+  Trie< char > copy { trie };
+  TrieTestAssert( copy.GetAllStrings().size() == keys.size() );
+
+  // shrink back down
+  for( size_t i { 0ULL }; i < keys.size(); ++i )
+  {
+    trie.Remove( keys[i] );
+    TrieTestAssert( !trie.HasString( keys[i] ) );
+    for( size_t j { i + 1ULL }; j < keys.size(); j += 17ULL )
+    {
+      TrieTestAssert( trie.HasString( keys[j] ) );
+    }
+  }
+
+  TrieTestAssert( trie.GetAllStrings().empty() );
+  TrieTestAssert( copy.GetAllStrings().size() == keys.size() );
+
+  return true;
+}
+
+template< typename CharTy >
+bool TestWideChars()
+{
+  Trie< CharTy > trie;
+
+  std::vector< std::basic_string< CharTy > > keys;
+  for( auto const& str : testData )
+  {
+    keys.emplace_back( str.begin(), str.end() );
+  }
+  keys.push_back( { static_cast< CharTy >( 0x4E2D ), static_cast< CharTy >( 0x6587 ) } );
+  keys.push_back( { static_cast< CharTy >( 0xFFFF ), static_cast< CharTy >( 0x7F ) } );
+
+  for( auto const& key : keys )
+  {
+    TrieTestAssert( trie.Insert( key ) != nullptr );
+  }
+
+  for( auto const& key : keys )
+  {
+    TrieTestAssert( trie.HasString( key ) );
+  }
+
+  auto actualStrings { trie.GetAllStrings() };
+  TrieTestAssert( actualStrings.size() == keys.size() );
+  TrieTestAssert( std::is_sorted( actualStrings.begin(), actualStrings.end() ) );
+
+  return true;
+}
+
 bool RunAllTests()
 {
   static std::vector< TestFn > tests
@@ -386,7 +2049,133 @@ bool RunAllTests()
     WrapTrieTest( ( TestGetAllStringsWithNodes< DataTrie< char, std::basic_string< char > > > ) ),
     WrapTrieTest( ( TestDataTrieInsert ) ),
     WrapTrieTest( ( TestAssignment< Trie< char > > ) ),
-    WrapTrieTest( ( TestAssignment< DataTrie< char, std::basic_string< char > > > ) )
+    WrapTrieTest( ( TestAssignment< DataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestInsert< Trie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestFind< Trie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestRemove< Trie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestHasString< Trie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestNumChildren< Trie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestGetAllStrings< Trie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestGetAllStringsWithNodes< Trie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestAssignment< Trie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestRemove< DataTrie< char, std::basic_string< char >, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestAssignment< DataTrie< char, std::basic_string< char >, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestArenaReuse ) ),
+    WrapTrieTest( ( TestFreeze< Trie< char > > ) ),
+    WrapTrieTest( ( TestFreeze< DataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestFreeze< Trie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestFreezeLarge ) ),
+    WrapTrieTest( ( TestDoubleArray< Trie< char > > ) ),
+    WrapTrieTest( ( TestDoubleArray< Trie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestDoubleArray< DataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestDoubleArrayData ) ),
+    WrapTrieTest( ( TestMappedTrie ) ),
+    WrapTrieTest( ( TestPersistentTrie ) ),
+    WrapTrieTest( ( TestPersistentTrieReaders ) ),
+    WrapTrieTest( ( TestConcurrentTrie ) ),
+    WrapTrieTest( ( TestConcurrentTrieThreads ) ),
+    WrapTrieTest( ( TestConcurrentTrieRemoveThreads ) ),
+    WrapTrieTest( ( TestShardedDataTrie ) ),
+    WrapTrieTest( ( TestBuildFromSorted< Trie< char > > ) ),
+    WrapTrieTest( ( TestBuildFromSorted< Trie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestDataTrieBuildFromSorted ) ),
+    WrapTrieTest( ( TestFindBatch< Trie< char > > ) ),
+    WrapTrieTest( ( TestFindBatch< Trie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestFindBatch< DataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestFindBatch< RadixTrie< char > > ) ),
+    WrapTrieTest( ( TestFindBatch< RadixDataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestIterators< Trie< char > > ) ),
+    WrapTrieTest( ( TestIterators< Trie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestIterators< DataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestIterators< RadixTrie< char > > ) ),
+    WrapTrieTest( ( TestIterators< RadixDataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestPrefixOf< Trie< char > > ) ),
+    WrapTrieTest( ( TestPrefixOf< Trie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestPrefixOf< DataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestPrefixOf< RadixTrie< char > > ) ),
+    WrapTrieTest( ( TestPrefixOf< RadixDataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestAhoCorasick< Trie< char > > ) ),
+    WrapTrieTest( ( TestAhoCorasick< Trie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestAhoCorasick< DataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestFuzzyFind< Trie< char > > ) ),
+    WrapTrieTest( ( TestFuzzyFind< Trie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestFuzzyFind< DataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestFuzzyFind< RadixTrie< char > > ) ),
+    WrapTrieTest( ( TestFuzzyFind< RadixDataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestMatch< Trie< char > > ) ),
+    WrapTrieTest( ( TestMatch< Trie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestMatch< DataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestMatch< RadixTrie< char > > ) ),
+    WrapTrieTest( ( TestMatch< RadixDataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestTopKWithPrefix< SharedNodeAllocator > ) ),
+    WrapTrieTest( ( TestTopKWithPrefix< ArenaNodeAllocator > ) ),
+    WrapTrieTest( ( TestRankSelect< CountedTrie< char > > ) ),
+    WrapTrieTest( ( TestRankSelect< CountedTrie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestRankSelect< CountedDataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestEmplace< DataTrie< char, CopyCounted > > ) ),
+    WrapTrieTest( ( TestEmplace< DataTrie< char, CopyCounted, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestEmplace< RadixDataTrie< char, CopyCounted > > ) ),
+    WrapTrieTest( ( TestEmplace< CountedDataTrie< char, CopyCounted > > ) ),
+    WrapTrieTest( ( TestUtf8Trie< char16_t > ) ),
+    WrapTrieTest( ( TestUtf8Trie< char32_t > ) ),
+    WrapTrieTest( ( TestUtf8Trie< wchar_t > ) ),
+    WrapTrieTest( ( TestAlphabet ) ),
+    WrapTrieTest( ( TestStaticTrie ) ),
+    WrapTrieTest( ( TestGetStats< Trie< char >, 14ULL > ) ),
+    WrapTrieTest( ( TestGetStats< Trie< char, ArenaNodeAllocator >, 14ULL > ) ),
+    WrapTrieTest( ( TestGetStats< DataTrie< char, std::basic_string< char > >, 14ULL > ) ),
+    WrapTrieTest( ( TestGetStats< RadixTrie< char >, 12ULL > ) ),
+    WrapTrieTest( ( TestGetStats< RadixDataTrie< char, std::basic_string< char > >, 12ULL > ) ),
+    WrapTrieTest( ( TestNodeCounters< Trie< char, CountingNodeAllocator<> > > ) ),
+    WrapTrieTest( ( TestNodeCounters< Trie< char, CountingNodeAllocator< ArenaNodeAllocator > > > ) ),
+    WrapTrieTest( ( TestNodeCounters< DataTrie< char, size_t, CountingNodeAllocator<> > > ) ),
+    WrapTrieTest( ( TestNodeCounters< RadixTrie< char, CountingNodeAllocator<> > > ) ),
+    WrapTrieTest( ( TestInstrumentation< Trie< char, SharedNodeAllocator, FullAlphabet< char >, TrieInstrumentation<> > > ) ),
+    WrapTrieTest( ( TestInstrumentation< DataTrie< char, std::basic_string< char >, ArenaNodeAllocator, FullAlphabet< char >, TrieInstrumentation< false > > > ) ),
+    WrapTrieTest( ( TestFind< Trie< char, SharedNodeAllocator, FullAlphabet< char >, TrieInstrumentation<> > > ) ),
+    WrapTrieTest( ( TestRemove< Trie< char, SharedNodeAllocator, FullAlphabet< char >, TrieInstrumentation<> > > ) ),
+    WrapTrieTest( ( TestInsert< Trie< char, SharedNodeAllocator, RangeAlphabet< char, 'A', 'z' > > > ) ),
+    WrapTrieTest( ( TestFind< Trie< char, SharedNodeAllocator, RangeAlphabet< char, 'A', 'z' > > > ) ),
+    WrapTrieTest( ( TestRemove< Trie< char, SharedNodeAllocator, RangeAlphabet< char, 'A', 'z' > > > ) ),
+    WrapTrieTest( ( TestGetAllStrings< Trie< char, SharedNodeAllocator, RangeAlphabet< char, 'A', 'z' > > > ) ),
+    WrapTrieTest( ( TestIterators< Trie< char, SharedNodeAllocator, RangeAlphabet< char, 'A', 'z' > > > ) ),
+    WrapTrieTest( ( TestPrefixOf< Trie< char, SharedNodeAllocator, RangeAlphabet< char, 'A', 'z' > > > ) ),
+    WrapTrieTest( ( TestFindBatch< Trie< char, SharedNodeAllocator, RangeAlphabet< char, 'A', 'z' > > > ) ),
+    WrapTrieTest( ( TestFuzzyFind< Trie< char, SharedNodeAllocator, RangeAlphabet< char, 'A', 'z' > > > ) ),
+    WrapTrieTest( ( TestAhoCorasick< Trie< char, SharedNodeAllocator, RangeAlphabet< char, 'A', 'z' > > > ) ),
+    WrapTrieTest( ( TestBuildFromSorted< Trie< char, SharedNodeAllocator, RangeAlphabet< char, 'A', 'z' > > > ) ),
+    WrapTrieTest( ( TestMatch< Trie< char, SharedNodeAllocator, RangeAlphabet< char, ' ', '~' > > > ) ),
+    WrapTrieTest( ( TestIterators< DataTrie< char, std::basic_string< char >, ArenaNodeAllocator, RangeAlphabet< char, 'A', 'z' > > > ) ),
+    WrapTrieTest( ( TestInsert< RadixTrie< char > > ) ),
+    WrapTrieTest( ( TestFind< RadixTrie< char > > ) ),
+    WrapTrieTest( ( TestRemove< RadixTrie< char > > ) ),
+    WrapTrieTest( ( TestHasString< RadixTrie< char > > ) ),
+    WrapTrieTest( ( TestNumChildren< RadixTrie< char > > ) ),
+    WrapTrieTest( ( TestGetAllStrings< RadixTrie< char > > ) ),
+    WrapTrieTest( ( TestGetAllStringsWithNodes< RadixTrie< char > > ) ),
+    WrapTrieTest( ( TestAssignment< RadixTrie< char > > ) ),
+    WrapTrieTest( ( TestRadixSplitMerge< RadixTrie< char > > ) ),
+    WrapTrieTest( ( TestInsert< RadixDataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestFind< RadixDataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestRemove< RadixDataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestHasString< RadixDataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestNumChildren< RadixDataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestGetAllStrings< RadixDataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestGetAllStringsWithNodes< RadixDataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestAssignment< RadixDataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestRadixSplitMerge< RadixDataTrie< char, std::basic_string< char > > > ) ),
+    WrapTrieTest( ( TestInsert< RadixTrie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestFind< RadixTrie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestRemove< RadixTrie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestHasString< RadixTrie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestNumChildren< RadixTrie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestGetAllStrings< RadixTrie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestGetAllStringsWithNodes< RadixTrie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestAssignment< RadixTrie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestRadixSplitMerge< RadixTrie< char, ArenaNodeAllocator > > ) ),
+    WrapTrieTest( ( TestAdaptiveChildren ) ),
+    WrapTrieTest( ( TestWideChars< char16_t > ) ),
+    WrapTrieTest( ( TestWideChars< char32_t > ) )
   };
 
   return std::all_of( tests.begin(), tests.end(), []( auto test )